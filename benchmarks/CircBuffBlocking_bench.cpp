@@ -0,0 +1,122 @@
+#include "libs/CircBuffBlocking.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const size_t kCapacity = 1024;
+const int64_t kItems = 1 << 20;
+
+// mutex + condvar queue that notifies on every push and pop, the baseline
+template<typename T>
+class NaiveBlockingQueue {
+ public:
+  explicit NaiveBlockingQueue(size_t capacity) : capacity_(capacity) {}
+
+  void push_wait(const T& el) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_full_.wait(lock, [this] { return items_.size() < capacity_; });
+      items_.push_back(el);
+    }
+    not_empty_.notify_one();
+  }
+
+  void pop_wait(T& out) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_empty_.wait(lock, [this] { return !items_.empty(); });
+      out = items_.front();
+      items_.pop_front();
+    }
+    not_full_.notify_one();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<T> items_;
+  size_t capacity_;
+};
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// One message in flight at a time, the consumer reports how long it took from
+// push to the return of pop_wait. With a pause between messages the consumer
+// is asleep when the message arrives, so this measures the wakeup.
+template<typename Queue>
+void BM_WakeupLatency(benchmark::State& state) {
+  const auto pause = std::chrono::microseconds(state.range(0));
+  Queue queue(kCapacity);
+  std::vector<int64_t> latencies;
+  std::atomic<int64_t> received{0};
+  std::thread consumer([&] {
+    int64_t stamp = 0;
+    while (true) {
+      queue.pop_wait(stamp);
+      if (stamp < 0) break;
+      latencies.push_back(NowNs() - stamp);
+      received.fetch_add(1, std::memory_order_release);
+    }
+  });
+  int64_t sent = 0;
+  for (auto _ : state) {
+    if (pause.count() != 0) std::this_thread::sleep_for(pause);
+    queue.push_wait(NowNs());
+    ++sent;
+    while (received.load(std::memory_order_acquire) != sent) std::this_thread::yield();
+  }
+  queue.push_wait(-1);
+  consumer.join();
+  std::sort(latencies.begin(), latencies.end());
+  state.counters["p50_ns"] = static_cast<double>(latencies[latencies.size() / 2]);
+  state.counters["p99_ns"] = static_cast<double>(latencies[latencies.size() * 99 / 100]);
+}
+
+// Streams kItems from one producer to one consumer as fast as possible.
+template<typename Queue, size_t Batch>
+void BM_BlockingTransfer(benchmark::State& state) {
+  Queue queue(kCapacity);
+  for (auto _ : state) {
+    std::thread producer([&queue] {
+      for (int64_t i = 0; i < kItems; ++i) {
+        queue.push_wait(i);
+      }
+    });
+    int64_t values[Batch];
+    for (int64_t received = 0; received < kItems;) {
+      if constexpr (Batch == 1) {
+        queue.pop_wait(values[0]);
+        ++received;
+      } else {
+        received += static_cast<int64_t>(queue.pop_wait_batch(values, Batch));
+      }
+    }
+    benchmark::DoNotOptimize(values[0]);
+    producer.join();
+  }
+  state.SetItemsProcessed(state.iterations() * kItems);
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_WakeupLatency, CircBuffBlocking<int64_t>)->Arg(0)->Arg(50)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_WakeupLatency, NaiveBlockingQueue<int64_t>)->Arg(0)->Arg(50)->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_BlockingTransfer, CircBuffBlocking<int64_t>, 1)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_BlockingTransfer, CircBuffBlocking<int64_t>, 64)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_BlockingTransfer, NaiveBlockingQueue<int64_t>, 1)->UseRealTime()->Unit(benchmark::kMillisecond);
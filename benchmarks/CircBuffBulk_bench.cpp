@@ -0,0 +1,92 @@
+#include "libs/CircBuff.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+const size_t kCapacity = 1 << 16;
+
+template<typename T>
+void BM_ElementwiseTransfer(benchmark::State& state) {
+  const auto batch = static_cast<size_t>(state.range(0));
+  CircBuff<T> buff(kCapacity);
+  std::vector<T> in(batch, T(1));
+  std::vector<T> out(batch);
+  for (auto _ : state) {
+    for (size_t i = 0; i < batch; ++i) {
+      buff.push(in[i]);
+    }
+    for (size_t i = 0; i < batch; ++i) {
+      out[i] = *buff.begin();
+      buff.pop();
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * batch * sizeof(T));
+}
+
+template<typename T>
+void BM_BulkTransfer(benchmark::State& state) {
+  const auto batch = static_cast<size_t>(state.range(0));
+  CircBuff<T> buff(kCapacity);
+  std::vector<T> in(batch, T(1));
+  std::vector<T> out(batch);
+  for (auto _ : state) {
+    buff.push_n(in.data(), batch);
+    buff.pop_n(out.data(), batch);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * batch * sizeof(T));
+}
+
+// Drains a batch by reading *begin() and popping one element at a time.
+template<typename T>
+void BM_PopLoopDrain(benchmark::State& state) {
+  const auto batch = static_cast<size_t>(state.range(0));
+  CircBuff<T> buff(kCapacity);
+  std::vector<T> in(batch, T(1));
+  for (auto _ : state) {
+    buff.push_n(in.data(), batch);
+    T sum = 0;
+    while (!buff.empty()) {
+      sum += *buff.begin();
+      buff.pop();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * batch * sizeof(T));
+}
+
+// The same with consume_all, per element and per span.
+template<typename T, bool Spans>
+void BM_ConsumeDrain(benchmark::State& state) {
+  const auto batch = static_cast<size_t>(state.range(0));
+  CircBuff<T> buff(kCapacity);
+  std::vector<T> in(batch, T(1));
+  for (auto _ : state) {
+    buff.push_n(in.data(), batch);
+    T sum = 0;
+    if constexpr (Spans) {
+      buff.consume_all([&](CircBuffSpan<T> span) {
+        for (T el : span) sum += el;
+      });
+    } else {
+      buff.consume_all([&](T& el) { sum += el; });
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * batch * sizeof(T));
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_ElementwiseTransfer, int16_t)->RangeMultiplier(4)->Range(256, 4096);
+BENCHMARK_TEMPLATE(BM_BulkTransfer, int16_t)->RangeMultiplier(4)->Range(256, 4096);
+BENCHMARK_TEMPLATE(BM_ElementwiseTransfer, float)->RangeMultiplier(4)->Range(256, 4096);
+BENCHMARK_TEMPLATE(BM_BulkTransfer, float)->RangeMultiplier(4)->Range(256, 4096);
+BENCHMARK_TEMPLATE(BM_PopLoopDrain, float)->RangeMultiplier(4)->Range(256, 4096);
+BENCHMARK_TEMPLATE(BM_ConsumeDrain, float, false)->RangeMultiplier(4)->Range(256, 4096);
+BENCHMARK_TEMPLATE(BM_ConsumeDrain, float, true)->RangeMultiplier(4)->Range(256, 4096);
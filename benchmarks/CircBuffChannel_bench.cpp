@@ -0,0 +1,47 @@
+#include "libs/CircBuffChannel.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace {
+
+const int64_t kMessages = 1 << 16;
+
+CircBuffTask Produce(CircBuffChannel<int64_t>& out) {
+  for (int64_t i = 0; i < kMessages; ++i) {
+    co_await out.push(i);
+  }
+}
+
+CircBuffTask Forward(CircBuffChannel<int64_t>& in, CircBuffChannel<int64_t>& out) {
+  for (int64_t i = 0; i < kMessages; ++i) {
+    co_await out.push(co_await in.pop());
+  }
+}
+
+CircBuffTask Consume(CircBuffChannel<int64_t>& in, int64_t& sum) {
+  for (int64_t i = 0; i < kMessages; ++i) {
+    sum += co_await in.pop();
+  }
+}
+
+// producer -> forwarding stage -> consumer, all on one executor
+void BM_ChannelPipeline(benchmark::State& state) {
+  CircBuffExecutor executor;
+  CircBuffChannel<int64_t> first(state.range(0), executor);
+  CircBuffChannel<int64_t> second(state.range(0), executor);
+  for (auto _ : state) {
+    int64_t sum = 0;
+    executor.spawn(Produce(first));
+    executor.spawn(Forward(first, second));
+    executor.spawn(Consume(second, sum));
+    executor.run();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kMessages);
+}
+
+}  // namespace
+
+BENCHMARK(BM_ChannelPipeline)->Arg(1)->Arg(64)->Arg(1024);
@@ -0,0 +1,53 @@
+#include "libs/CircBuff.h"
+
+#include <benchmark/benchmark.h>
+
+#include <deque>
+
+namespace {
+
+const int kSize = 4096;
+
+enum Where { kFront, kMiddle, kBack };
+
+int PositionFor(int where) {
+  switch (where) {
+    case kFront: return 0;
+    case kMiddle: return kSize / 2;
+    default: return kSize;
+  }
+}
+
+// every iteration inserts one element and erases it again, so the size stays fixed
+void BM_CircBuffInsertErase(benchmark::State& state) {
+  CircBuff<int> buff(2 * kSize);
+  for (int i = 0; i < kSize; ++i) {
+    buff.push(i);
+  }
+  const int pos = PositionFor(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    auto it = buff.insert(buff.begin() + pos, 42);
+    benchmark::DoNotOptimize(*it);
+    buff.erase(buff.begin() + pos);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_DequeInsertErase(benchmark::State& state) {
+  std::deque<int> deque;
+  for (int i = 0; i < kSize; ++i) {
+    deque.push_back(i);
+  }
+  const int pos = PositionFor(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    auto it = deque.insert(deque.begin() + pos, 42);
+    benchmark::DoNotOptimize(*it);
+    deque.erase(deque.begin() + pos);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(BM_CircBuffInsertErase)->Arg(kFront)->Arg(kMiddle)->Arg(kBack);
+BENCHMARK(BM_DequeInsertErase)->Arg(kFront)->Arg(kMiddle)->Arg(kBack);
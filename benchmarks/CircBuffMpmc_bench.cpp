@@ -0,0 +1,91 @@
+#include "MutexCircBuff.h"
+#include "libs/CircBuffMpmc.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int64_t kItems = 1 << 18;
+const size_t kCapacity = 1024;
+
+// range(0) producers and range(0) consumers move kItems elements in total
+template<typename Queue>
+void TransferItems(Queue& queue, int threads) {
+  std::atomic<int64_t> received{0};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&queue, threads] {
+      for (int64_t i = 0; i < kItems / threads; ++i) {
+        while (!queue.try_push(i)) std::this_thread::yield();
+      }
+    });
+    workers.emplace_back([&queue, &received, threads] {
+      int64_t value = 0;
+      while (received.load(std::memory_order_relaxed) < kItems / threads * threads) {
+        if (queue.try_pop(value)) received.fetch_add(1, std::memory_order_relaxed);
+        else std::this_thread::yield();
+      }
+      benchmark::DoNotOptimize(value);
+    });
+  }
+  for (auto& worker : workers) worker.join();
+}
+
+void BM_MpmcTransfer(benchmark::State& state) {
+  CircBuffMpmc<int64_t> queue(kCapacity);
+  for (auto _ : state) {
+    TransferItems(queue, static_cast<int>(state.range(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * kItems);
+}
+
+void BM_MpmcBatchTransfer(benchmark::State& state) {
+  const auto threads = static_cast<int>(state.range(0));
+  const size_t batch = 32;
+  CircBuffMpmc<int64_t> queue(kCapacity);
+  for (auto _ : state) {
+    std::atomic<int64_t> received{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+      workers.emplace_back([&queue, threads] {
+        int64_t values[batch] = {};
+        for (int64_t sent = 0; sent < kItems / threads;) {
+          size_t n = std::min<int64_t>(batch, kItems / threads - sent);
+          size_t pushed = queue.try_push_n(values, n);
+          if (pushed == 0) std::this_thread::yield();
+          sent += static_cast<int64_t>(pushed);
+        }
+      });
+      workers.emplace_back([&queue, &received, threads] {
+        int64_t values[batch];
+        while (received.load(std::memory_order_relaxed) < kItems / threads * threads) {
+          size_t popped = queue.try_pop_n(values, batch);
+          if (popped == 0) std::this_thread::yield();
+          received.fetch_add(static_cast<int64_t>(popped), std::memory_order_relaxed);
+        }
+      });
+    }
+    for (auto& worker : workers) worker.join();
+  }
+  state.SetItemsProcessed(state.iterations() * kItems);
+}
+
+void BM_MutexCircBuffMpmcTransfer(benchmark::State& state) {
+  MutexCircBuff<int64_t> queue(kCapacity);
+  for (auto _ : state) {
+    TransferItems(queue, static_cast<int>(state.range(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * kItems);
+}
+
+}  // namespace
+
+BENCHMARK(BM_MpmcTransfer)->RangeMultiplier(2)->Range(1, 8)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MpmcBatchTransfer)->RangeMultiplier(2)->Range(1, 8)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MutexCircBuffMpmcTransfer)->RangeMultiplier(2)->Range(1, 8)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,51 @@
+#include "libs/CircBuff.h"
+#include "libs/CircBuffPersistent.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+const size_t kCapacity = 1 << 16;
+
+struct Event {
+  int64_t timestamp;
+  int64_t id;
+  double value;
+};
+
+// in-memory ring, the upper bound
+void BM_MemoryPush(benchmark::State& state) {
+  CircBuff<Event> buff(kCapacity);
+  int64_t i = 0;
+  for (auto _ : state) {
+    buff.push(Event{i, i, 1.0});
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// the argument is sync_every: 0 never msyncs, N msyncs every N commits
+void BM_PersistentPush(benchmark::State& state) {
+  char name[] = "/tmp/CircBuffPersistentBenchXXXXXX";
+  close(mkstemp(name));
+  unlink(name);
+  {
+    CircBuffPersistent<Event> buff(name, kCapacity, static_cast<size_t>(state.range(0)));
+    int64_t i = 0;
+    for (auto _ : state) {
+      buff.push(Event{i, i, 1.0});
+      ++i;
+    }
+  }
+  unlink(name);
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(BM_MemoryPush);
+BENCHMARK(BM_PersistentPush)->ArgName("sync_every")->Arg(0)->Arg(4096)->Arg(64)->Arg(1);
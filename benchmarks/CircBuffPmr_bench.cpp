@@ -0,0 +1,46 @@
+#include "libs/CircBuff.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+
+namespace {
+
+const int kRingsPerRequest = 64;
+const size_t kRingCapacity = 16;
+
+// One request: creates a batch of short-lived rings, fills them and tears them down.
+template<typename Ring, typename... AllocArgs>
+void HandleRequest(AllocArgs&& ... alloc_args) {
+  for (int i = 0; i < kRingsPerRequest; ++i) {
+    Ring ring(kRingCapacity, alloc_args...);
+    for (size_t j = 0; j < kRingCapacity + 4; ++j) {
+      ring.push(typename Ring::value_type(static_cast<int>(j)));
+    }
+    benchmark::DoNotOptimize(ring[0]);
+  }
+}
+
+void BM_HeapRings(benchmark::State& state) {
+  for (auto _ : state) {
+    HandleRequest<CircBuff<int64_t>>();
+  }
+  state.SetItemsProcessed(state.iterations() * kRingsPerRequest);
+}
+
+// every request gets a fresh arena on a stack buffer, freed all at once
+void BM_ArenaRings(benchmark::State& state) {
+  std::byte storage[kRingsPerRequest * kRingCapacity * sizeof(int64_t) + 1024];
+  for (auto _ : state) {
+    std::pmr::monotonic_buffer_resource arena(storage, sizeof(storage));
+    HandleRequest<pmr::CircBuff<int64_t>>(&arena);
+  }
+  state.SetItemsProcessed(state.iterations() * kRingsPerRequest);
+}
+
+}  // namespace
+
+BENCHMARK(BM_HeapRings);
+BENCHMARK(BM_ArenaRings);
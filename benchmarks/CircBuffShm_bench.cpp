@@ -0,0 +1,78 @@
+#include "libs/CircBuffShm.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+namespace {
+
+// Round trip between two processes: the parent sends a value, the child
+// echoes it back, and the parent waits for the echo. Both sides poll and
+// yield, so the benchmark also works with fewer cores than processes.
+void BM_ShmPingPong(benchmark::State& state) {
+  const std::string name = "/CircBuffShmBench-" + std::to_string(getpid());
+  CircBuffShm<int64_t> ping(name + "-ping", 64);
+  CircBuffShm<int64_t> pong(name + "-pong", 64);
+  const pid_t child = fork();
+  if (child == 0) {
+    CircBuffShm<int64_t> in(name + "-ping");
+    CircBuffShm<int64_t> out(name + "-pong");
+    int64_t value = 0;
+    do {
+      while (!in.try_pop(value)) std::this_thread::yield();
+      while (!out.try_push(value)) std::this_thread::yield();
+    } while (value >= 0);
+    _exit(0);
+  }
+  int64_t value = 0;
+  for (auto _ : state) {
+    ping.try_push(value);
+    while (!pong.try_pop(value)) std::this_thread::yield();
+    ++value;
+  }
+  ping.try_push(-1);
+  while (!pong.try_pop(value)) std::this_thread::yield();
+  waitpid(child, nullptr, 0);
+  state.SetItemsProcessed(state.iterations());
+}
+
+// the same round trip over a Unix socketpair, the way the services talk today
+void BM_SocketPingPong(benchmark::State& state) {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    state.SkipWithError("socketpair failed");
+    return;
+  }
+  const pid_t child = fork();
+  if (child == 0) {
+    int64_t value = 0;
+    do {
+      if (read(fds[1], &value, sizeof(value)) != sizeof(value)) _exit(1);
+      if (write(fds[1], &value, sizeof(value)) != sizeof(value)) _exit(1);
+    } while (value >= 0);
+    _exit(0);
+  }
+  int64_t value = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(write(fds[0], &value, sizeof(value)));
+    benchmark::DoNotOptimize(read(fds[0], &value, sizeof(value)));
+    ++value;
+  }
+  value = -1;
+  benchmark::DoNotOptimize(write(fds[0], &value, sizeof(value)));
+  benchmark::DoNotOptimize(read(fds[0], &value, sizeof(value)));
+  waitpid(child, nullptr, 0);
+  close(fds[0]);
+  close(fds[1]);
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(BM_ShmPingPong)->UseRealTime();
+BENCHMARK(BM_SocketPingPong)->UseRealTime();
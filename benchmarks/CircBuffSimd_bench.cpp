@@ -0,0 +1,122 @@
+#include "libs/CircBuffSimd.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+namespace {
+
+const size_t kSize = 1 << 16;
+
+// full buffer whose contents start in the middle of the block
+template<typename T>
+CircBuff<T> MakeWrapped() {
+  CircBuff<T> buff(kSize);
+  for (size_t i = 0; i < kSize + kSize / 3; ++i) {
+    buff.push(static_cast<T>(i % 1000));
+  }
+  return buff;
+}
+
+template<typename T>
+void BM_Accumulate(benchmark::State& state) {
+  const auto buff = MakeWrapped<T>();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::accumulate(buff.begin(), buff.end(), CircBuffSimd::sum_type<T>(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+template<typename T>
+void BM_SimdSum(benchmark::State& state) {
+  const auto buff = MakeWrapped<T>();
+  const auto isa = static_cast<CircBuffIsa>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CircBuffSimd::sum(buff, isa));
+  }
+  state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+template<typename T>
+void BM_MinElement(benchmark::State& state) {
+  const auto buff = MakeWrapped<T>();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(*std::min_element(buff.begin(), buff.end()));
+  }
+  state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+template<typename T>
+void BM_SimdMin(benchmark::State& state) {
+  const auto buff = MakeWrapped<T>();
+  const auto isa = static_cast<CircBuffIsa>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CircBuffSimd::min(buff, isa));
+  }
+  state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+// the needle is absent, so the whole buffer is scanned
+template<typename T>
+void BM_StdFind(benchmark::State& state) {
+  const auto buff = MakeWrapped<T>();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::find(buff.begin(), buff.end(), T(5000)));
+  }
+  state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+template<typename T>
+void BM_SimdFind(benchmark::State& state) {
+  const auto buff = MakeWrapped<T>();
+  const auto isa = static_cast<CircBuffIsa>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CircBuffSimd::find(buff, T(5000), isa));
+  }
+  state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+template<typename T>
+void BM_StdCount(benchmark::State& state) {
+  const auto buff = MakeWrapped<T>();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::count(buff.begin(), buff.end(), T(7)));
+  }
+  state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+template<typename T>
+void BM_SimdCount(benchmark::State& state) {
+  const auto buff = MakeWrapped<T>();
+  const auto isa = static_cast<CircBuffIsa>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CircBuffSimd::count(buff, T(7), isa));
+  }
+  state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+// the argument is the CircBuffIsa: 0 scalar, 1 sse4.2, 2 avx2
+void IsaArgs(benchmark::internal::Benchmark* bench) {
+  bench->ArgName("isa")->Arg(0)->Arg(1)->Arg(2);
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_Accumulate, int32_t);
+BENCHMARK_TEMPLATE(BM_SimdSum, int32_t)->Apply(IsaArgs);
+BENCHMARK_TEMPLATE(BM_Accumulate, float);
+BENCHMARK_TEMPLATE(BM_SimdSum, float)->Apply(IsaArgs);
+BENCHMARK_TEMPLATE(BM_Accumulate, double);
+BENCHMARK_TEMPLATE(BM_SimdSum, double)->Apply(IsaArgs);
+
+BENCHMARK_TEMPLATE(BM_MinElement, int32_t);
+BENCHMARK_TEMPLATE(BM_SimdMin, int32_t)->Apply(IsaArgs);
+BENCHMARK_TEMPLATE(BM_MinElement, int64_t);
+BENCHMARK_TEMPLATE(BM_SimdMin, int64_t)->Apply(IsaArgs);
+
+BENCHMARK_TEMPLATE(BM_StdFind, int32_t);
+BENCHMARK_TEMPLATE(BM_SimdFind, int32_t)->Apply(IsaArgs);
+BENCHMARK_TEMPLATE(BM_StdCount, double);
+BENCHMARK_TEMPLATE(BM_SimdCount, double)->Apply(IsaArgs);
@@ -0,0 +1,71 @@
+#include "libs/CircBuffSimd.h"
+#include "libs/CircBuffSoa.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace {
+
+const size_t kTicks = 1 << 18;
+
+struct Tick {
+  int64_t timestamp;
+  double price;
+  int32_t qty;
+  uint8_t flags;
+};
+
+using TickColumns = CircBuffSoa<int64_t, double, int32_t, uint8_t>;
+
+// sums the prices of a ring of whole records
+void BM_AosPriceScan(benchmark::State& state) {
+  CircBuff<Tick> ring(kTicks);
+  for (size_t i = 0; i < kTicks + kTicks / 3; ++i) {
+    ring.push(Tick{static_cast<int64_t>(i), static_cast<double>(i % 100), 1, 0});
+  }
+  for (auto _ : state) {
+    double sum = 0;
+    for (const Tick& tick : ring) {
+      sum += tick.price;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kTicks);
+}
+
+void Fill(TickColumns& ring) {
+  for (size_t i = 0; i < kTicks + kTicks / 3; ++i) {
+    ring.push(static_cast<int64_t>(i), static_cast<double>(i % 100), 1, 0);
+  }
+}
+
+// the same scan over the price column only, with a plain loop per segment
+void BM_SoaPriceScan(benchmark::State& state) {
+  TickColumns ring(kTicks);
+  Fill(ring);
+  for (auto _ : state) {
+    double sum = 0;
+    for (double price : ring.array_one<1>()) sum += price;
+    for (double price : ring.array_two<1>()) sum += price;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kTicks);
+}
+
+// and with the SIMD kernel over the column segments
+void BM_SoaPriceSimdSum(benchmark::State& state) {
+  TickColumns columns(kTicks);
+  Fill(columns);
+  const TickColumns& ring = columns;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CircBuffSimd::sum(ring.array_one<1>()) + CircBuffSimd::sum(ring.array_two<1>()));
+  }
+  state.SetItemsProcessed(state.iterations() * kTicks);
+}
+
+}  // namespace
+
+BENCHMARK(BM_AosPriceScan);
+BENCHMARK(BM_SoaPriceScan);
+BENCHMARK(BM_SoaPriceSimdSum);
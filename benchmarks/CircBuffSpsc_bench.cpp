@@ -0,0 +1,48 @@
+#include "MutexCircBuff.h"
+#include "libs/CircBuffSpsc.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <thread>
+
+namespace {
+
+const int64_t kItems = 1 << 20;
+
+template<typename Queue>
+void TransferItems(Queue& queue) {
+  std::thread producer([&queue] {
+    for (int64_t i = 0; i < kItems; ++i) {
+      while (!queue.try_push(i)) std::this_thread::yield();
+    }
+  });
+  int64_t value = 0;
+  for (int64_t received = 0; received < kItems;) {
+    if (queue.try_pop(value)) ++received;
+    else std::this_thread::yield();
+  }
+  benchmark::DoNotOptimize(value);
+  producer.join();
+}
+
+void BM_SpscTransfer(benchmark::State& state) {
+  CircBuffSpsc<int64_t> queue(state.range(0));
+  for (auto _ : state) {
+    TransferItems(queue);
+  }
+  state.SetItemsProcessed(state.iterations() * kItems);
+}
+
+void BM_MutexCircBuffTransfer(benchmark::State& state) {
+  MutexCircBuff<int64_t> queue(state.range(0));
+  for (auto _ : state) {
+    TransferItems(queue);
+  }
+  state.SetItemsProcessed(state.iterations() * kItems);
+}
+
+}  // namespace
+
+BENCHMARK(BM_SpscTransfer)->Arg(64)->Arg(1024)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MutexCircBuffTransfer)->Arg(64)->Arg(1024)->UseRealTime()->Unit(benchmark::kMillisecond);
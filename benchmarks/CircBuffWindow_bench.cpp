@@ -0,0 +1,52 @@
+#include "libs/CircBuffWindow.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+int64_t NextSample(uint32_t& state) {
+  state = state * 1664525 + 1013904223;
+  return state >> 8;
+}
+
+// one sample per iteration, aggregates maintained incrementally
+void BM_WindowPush(benchmark::State& state) {
+  CircBuffWindow<int64_t> window(state.range(0));
+  uint32_t seed = 1;
+  for (auto _ : state) {
+    window.push(NextSample(seed));
+    benchmark::DoNotOptimize(window.sum());
+    benchmark::DoNotOptimize(window.min());
+    benchmark::DoNotOptimize(window.max());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// one sample per iteration, aggregates recomputed by iterating the ring
+void BM_WindowRecompute(benchmark::State& state) {
+  CircBuff<int64_t> window(state.range(0));
+  uint32_t seed = 1;
+  for (auto _ : state) {
+    window.push(NextSample(seed));
+    int64_t sum = 0;
+    int64_t min = *window.begin();
+    int64_t max = min;
+    for (int64_t sample : window) {
+      sum += sample;
+      min = std::min(min, sample);
+      max = std::max(max, sample);
+    }
+    benchmark::DoNotOptimize(sum);
+    benchmark::DoNotOptimize(min);
+    benchmark::DoNotOptimize(max);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(BM_WindowPush)->Arg(1000)->Arg(100'000);
+BENCHMARK(BM_WindowRecompute)->Arg(1000)->Arg(100'000);
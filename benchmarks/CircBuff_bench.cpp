@@ -0,0 +1,296 @@
+#include "libs/CircBuff.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int kSize = 1 << 12;
+
+template<typename T>
+T MakeValue(int i);
+
+template<>
+int MakeValue<int>(int i) {
+  return i;
+}
+
+template<>
+std::string MakeValue<std::string>(int i) {
+  return std::string(24, static_cast<char>('a' + i % 26));
+}
+
+template<typename T, typename Stats = CircBuffNoStats>
+CircBuff<T, std::allocator<T>, CircBuffModuloCapacity, CircBuffOnFull::overwrite, Stats> MakeFullCircBuff() {
+  // hidden from the optimizer, otherwise a known capacity turns the modulo into a mask in some builds only
+  size_t capacity = kSize;
+  benchmark::DoNotOptimize(capacity);
+  CircBuff<T, std::allocator<T>, CircBuffModuloCapacity, CircBuffOnFull::overwrite, Stats> buff(capacity);
+  for (int i = 0; i < kSize; ++i) {
+    buff.push(MakeValue<T>(i));
+  }
+  return buff;
+}
+
+template<typename Container>
+Container MakeFull() {
+  Container container;
+  for (int i = 0; i < kSize; ++i) {
+    container.push_back(MakeValue<typename Container::value_type>(i));
+  }
+  return container;
+}
+
+// push/pop at a steady size
+
+// Stats = CircBuffStats shows what the counting instrumentation costs
+template<typename T, typename Stats = CircBuffNoStats>
+void BM_CircBuffPushPop(benchmark::State& state) {
+  auto buff = MakeFullCircBuff<T, Stats>();
+  const T value = MakeValue<T>(1);
+  for (auto _ : state) {
+    buff.push(value);
+    buff.pop();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void BM_DequePushPop(benchmark::State& state) {
+  auto deque = MakeFull<std::deque<T>>();
+  const T value = MakeValue<T>(1);
+  for (auto _ : state) {
+    deque.push_back(value);
+    deque.pop_front();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// full traversal
+
+template<typename T>
+void BM_CircBuffIterate(benchmark::State& state) {
+  CircBuff<T> buff = MakeFullCircBuff<T>();
+  for (auto _ : state) {
+    for (const auto& el : buff) {
+      benchmark::DoNotOptimize(el);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+template<typename Container>
+void BM_StdIterate(benchmark::State& state) {
+  auto container = MakeFull<Container>();
+  for (auto _ : state) {
+    for (const auto& el : container) {
+      benchmark::DoNotOptimize(el);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+// random access through operator[]
+
+template<typename Container>
+void RandomAccess(benchmark::State& state, Container& container) {
+  uint32_t index = 1;
+  for (auto _ : state) {
+    index = index * 1664525 + 1013904223;
+    benchmark::DoNotOptimize(container[index % kSize]);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void BM_CircBuffRandomAccess(benchmark::State& state) {
+  CircBuff<T> buff = MakeFullCircBuff<T>();
+  RandomAccess(state, buff);
+}
+
+template<typename Container>
+void BM_StdRandomAccess(benchmark::State& state) {
+  auto container = MakeFull<Container>();
+  RandomAccess(state, container);
+}
+
+// insert and erase in the middle
+
+template<typename T>
+void BM_CircBuffInsertEraseMiddle(benchmark::State& state) {
+  CircBuff<T> buff = MakeFullCircBuff<T>();
+  buff.reserve(kSize + 1);
+  const T value = MakeValue<T>(1);
+  for (auto _ : state) {
+    buff.insert(buff.begin() + kSize / 2, value);
+    buff.erase(buff.begin() + kSize / 2);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template<typename Container>
+void BM_StdInsertEraseMiddle(benchmark::State& state) {
+  auto container = MakeFull<Container>();
+  const auto value = MakeValue<typename Container::value_type>(1);
+  for (auto _ : state) {
+    container.insert(container.begin() + kSize / 2, value);
+    container.erase(container.begin() + kSize / 2);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// growth from empty
+
+template<typename T, typename Growth = CircBuffGrowth<>>
+void BM_CircBuffExtendedGrowth(benchmark::State& state) {
+  const T value = MakeValue<T>(1);
+  for (auto _ : state) {
+    CircBuffExtended<T, std::allocator<T>, CircBuffModuloCapacity, Growth> buff;
+    for (int i = 0; i < kSize; ++i) {
+      buff.push(value);
+    }
+    benchmark::DoNotOptimize(buff.size());
+  }
+  state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+// Slowest single push while growing to 64 * kSize elements. The smallest
+// maximum over the runs is reported, so a run preempted mid-push does not count.
+template<typename T, typename Growth>
+void BM_CircBuffExtendedWorstPush(benchmark::State& state) {
+  const T value = MakeValue<T>(1);
+  int64_t worst_ns = INT64_MAX;
+  for (auto _ : state) {
+    CircBuffExtended<T, std::allocator<T>, CircBuffModuloCapacity, Growth> buff;
+    int64_t run_worst_ns = 0;
+    for (int i = 0; i < 64 * kSize; ++i) {
+      const auto start = std::chrono::steady_clock::now();
+      buff.push(value);
+      const auto elapsed = std::chrono::steady_clock::now() - start;
+      run_worst_ns = std::max<int64_t>(run_worst_ns,
+                                       std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+    worst_ns = std::min(worst_ns, run_worst_ns);
+    benchmark::DoNotOptimize(buff.size());
+  }
+  state.SetItemsProcessed(state.iterations() * 64 * kSize);
+  state.counters["worst_push_ns"] = static_cast<double>(worst_ns);
+}
+
+template<typename Container>
+void BM_StdGrowth(benchmark::State& state) {
+  const auto value = MakeValue<typename Container::value_type>(1);
+  for (auto _ : state) {
+    Container container;
+    for (int i = 0; i < kSize; ++i) {
+      container.push_back(value);
+    }
+    benchmark::DoNotOptimize(container.size());
+  }
+  state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+// copy construction and copy assignment
+
+template<typename T>
+void BM_CircBuffCopy(benchmark::State& state) {
+  CircBuff<T> buff = MakeFullCircBuff<T>();
+  for (auto _ : state) {
+    CircBuff<T> copy(buff);
+    benchmark::DoNotOptimize(copy.size());
+  }
+  state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+template<typename T>
+void BM_CircBuffAssign(benchmark::State& state) {
+  CircBuff<T> buff = MakeFullCircBuff<T>();
+  CircBuff<T> target(kSize);
+  for (auto _ : state) {
+    target = buff;
+    benchmark::DoNotOptimize(target.size());
+  }
+  state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+template<typename Container>
+void BM_StdCopy(benchmark::State& state) {
+  auto container = MakeFull<Container>();
+  for (auto _ : state) {
+    Container copy(container);
+    benchmark::DoNotOptimize(copy.size());
+  }
+  state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+template<typename Container>
+void BM_StdAssign(benchmark::State& state) {
+  auto container = MakeFull<Container>();
+  Container target;
+  for (auto _ : state) {
+    target = container;
+    benchmark::DoNotOptimize(target.size());
+  }
+  state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_CircBuffPushPop, int);
+BENCHMARK_TEMPLATE(BM_CircBuffPushPop, std::string);
+BENCHMARK_TEMPLATE(BM_CircBuffPushPop, int, CircBuffStats);
+BENCHMARK_TEMPLATE(BM_DequePushPop, int);
+BENCHMARK_TEMPLATE(BM_DequePushPop, std::string);
+
+BENCHMARK_TEMPLATE(BM_CircBuffIterate, int);
+BENCHMARK_TEMPLATE(BM_CircBuffIterate, std::string);
+BENCHMARK_TEMPLATE(BM_StdIterate, std::deque<int>);
+BENCHMARK_TEMPLATE(BM_StdIterate, std::deque<std::string>);
+BENCHMARK_TEMPLATE(BM_StdIterate, std::vector<int>);
+BENCHMARK_TEMPLATE(BM_StdIterate, std::vector<std::string>);
+
+BENCHMARK_TEMPLATE(BM_CircBuffRandomAccess, int);
+BENCHMARK_TEMPLATE(BM_CircBuffRandomAccess, std::string);
+BENCHMARK_TEMPLATE(BM_StdRandomAccess, std::deque<int>);
+BENCHMARK_TEMPLATE(BM_StdRandomAccess, std::deque<std::string>);
+BENCHMARK_TEMPLATE(BM_StdRandomAccess, std::vector<int>);
+BENCHMARK_TEMPLATE(BM_StdRandomAccess, std::vector<std::string>);
+
+BENCHMARK_TEMPLATE(BM_CircBuffInsertEraseMiddle, int);
+BENCHMARK_TEMPLATE(BM_CircBuffInsertEraseMiddle, std::string);
+BENCHMARK_TEMPLATE(BM_StdInsertEraseMiddle, std::deque<int>);
+BENCHMARK_TEMPLATE(BM_StdInsertEraseMiddle, std::deque<std::string>);
+BENCHMARK_TEMPLATE(BM_StdInsertEraseMiddle, std::vector<int>);
+BENCHMARK_TEMPLATE(BM_StdInsertEraseMiddle, std::vector<std::string>);
+
+BENCHMARK_TEMPLATE(BM_CircBuffExtendedGrowth, int);
+BENCHMARK_TEMPLATE(BM_CircBuffExtendedGrowth, std::string);
+BENCHMARK_TEMPLATE(BM_CircBuffExtendedGrowth, int, CircBuffIncrementalGrowth<>);
+BENCHMARK_TEMPLATE(BM_CircBuffExtendedGrowth, std::string, CircBuffIncrementalGrowth<>);
+BENCHMARK_TEMPLATE(BM_CircBuffExtendedWorstPush, int, CircBuffGrowth<>);
+BENCHMARK_TEMPLATE(BM_CircBuffExtendedWorstPush, int, CircBuffIncrementalGrowth<>);
+BENCHMARK_TEMPLATE(BM_CircBuffExtendedWorstPush, std::string, CircBuffGrowth<>);
+BENCHMARK_TEMPLATE(BM_CircBuffExtendedWorstPush, std::string, CircBuffIncrementalGrowth<>);
+BENCHMARK_TEMPLATE(BM_StdGrowth, std::deque<int>);
+BENCHMARK_TEMPLATE(BM_StdGrowth, std::deque<std::string>);
+BENCHMARK_TEMPLATE(BM_StdGrowth, std::vector<int>);
+BENCHMARK_TEMPLATE(BM_StdGrowth, std::vector<std::string>);
+
+BENCHMARK_TEMPLATE(BM_CircBuffCopy, int);
+BENCHMARK_TEMPLATE(BM_CircBuffCopy, std::string);
+BENCHMARK_TEMPLATE(BM_CircBuffAssign, int);
+BENCHMARK_TEMPLATE(BM_CircBuffAssign, std::string);
+BENCHMARK_TEMPLATE(BM_StdCopy, std::deque<int>);
+BENCHMARK_TEMPLATE(BM_StdCopy, std::vector<int>);
+BENCHMARK_TEMPLATE(BM_StdCopy, std::vector<std::string>);
+BENCHMARK_TEMPLATE(BM_StdAssign, std::deque<int>);
+BENCHMARK_TEMPLATE(BM_StdAssign, std::vector<int>);
+BENCHMARK_TEMPLATE(BM_StdAssign, std::vector<std::string>);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "libs/CircBuff.h"
+
+#include <mutex>
+
+// CircBuff behind a global lock, the baseline the concurrent rings are measured against
+template<typename T>
+class MutexCircBuff {
+ public:
+  explicit MutexCircBuff(size_t capacity) : buff_(capacity) {}
+
+  bool try_push(const T& el) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (buff_.size() == buff_.capacity()) return false;
+    buff_.push(el);
+    return true;
+  }
+
+  bool try_pop(T& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (buff_.empty()) return false;
+    out = *buff_.begin();
+    buff_.pop();
+    return true;
+  }
+
+ private:
+  std::mutex mutex_;
+  CircBuff<T> buff_;
+};
@@ -17,7 +17,7 @@ void print_buffer(CircBuff<T>& buff) {
 int main() {
   CircBuff<int> buf({1, 2});
   buf.insert(buf.begin() + 1, {3, 4, 5});
-//  std::sort(buf.begin(), buf.end());
+  std::sort(buf.begin(), buf.end());
   print_buffer(buf);
   return 0;
 }
\ No newline at end of file
@@ -1,10 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
 #include <iterator>
 #include <memory>
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+#include <ratio>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Capacity policies decide how a requested capacity is rounded and how a
+// position is wrapped back into [0, capacity).
+
+// Any capacity is kept as is, positions wrap with an integer division.
+struct CircBuffModuloCapacity {
+  static constexpr size_t round(size_t capacity) {
+    return capacity;
+  }
+  static constexpr size_t wrap(size_t index, size_t capacity) {
+    return index % capacity;
+  }
+};
+
+// Capacity is rounded up to a power of two, positions wrap with a mask.
+struct CircBuffPow2Capacity {
+  static constexpr size_t round(size_t capacity) {
+    size_t result = 1;
+    while (result < capacity) result <<= 1;
+    return capacity == 0 ? 0 : result;
+  }
+  static constexpr size_t wrap(size_t index, size_t capacity) {
+    return index & (capacity - 1);
+  }
+};
+
+// Alignment that keeps data written by different threads, or read as
+// separate columns, on cache lines of their own.
+inline constexpr size_t kCircBuffCacheLine = 64;
+
+// What a push into a full buffer does: overwrite the oldest element, drop the
+// new one, or wait for a free slot. Waiting needs another thread to pop, so
+// it is only available in CircBuffSpsc and CircBuffMpmc.
+enum class CircBuffOnFull {
+  overwrite,
+  reject,
+  block,
+};
+
+// Growth policy of CircBuffExtended: a full buffer grows to
+// capacity * Factor + Step slots, but never beyond MaxCapacity (before the
+// capacity policy rounds it). Once the cap is reached pushes overwrite the
+// oldest element like CircBuff does.
+template<typename Factor = std::ratio<2>, size_t Step = 0, size_t MaxCapacity = SIZE_MAX>
+struct CircBuffGrowth {
+  static_assert(Factor::num > Factor::den || Step > 0, "growth policy must increase the capacity");
+
+  // 0 moves all elements to the new block during the push that grows it
+  static constexpr size_t moves_per_push = 0;
+
+  static constexpr size_t next(size_t capacity, size_t min_capacity) {
+    size_t result = capacity == 0 ? 1 : capacity;
+    while (result < min_capacity && result < MaxCapacity) {
+      const size_t grown = result / Factor::den * Factor::num + result % Factor::den * Factor::num / Factor::den + Step;
+      result = std::max(grown, result + 1);
+    }
+    return std::min(result, MaxCapacity);
+  }
+};
+
+// Same sizes as CircBuffGrowth, but a push that grows the buffer only
+// allocates the new block. The old elements stay in the previous block and
+// each later push moves at least MovesPerPush of them, more if needed to
+// finish before the new block fills up, so no single push copies the whole
+// contents. Pops take the oldest elements straight from the previous block,
+// any other access finishes the move first. A CircBuff reference to the
+// buffer sees only the moved elements, call finish_growth() before handing
+// it to code that takes one.
+template<typename Factor = std::ratio<2>, size_t Step = 0, size_t MaxCapacity = SIZE_MAX, size_t MovesPerPush = 4>
+struct CircBuffIncrementalGrowth : CircBuffGrowth<Factor, Step, MaxCapacity> {
+  static_assert(MovesPerPush > 0, "incremental growth has to move at least one element per push");
+
+  static constexpr size_t moves_per_push = MovesPerPush;
+};
+
+// Shrink policies of CircBuffExtended. By default capacity never shrinks.
+struct CircBuffNoShrink {
+  static constexpr bool enabled = false;
+  static constexpr bool low(size_t, size_t) { return false; }
+  static constexpr size_t pops = 0;
+  static constexpr size_t next(size_t capacity) { return capacity; }
+};
+
+// Halves the capacity, down to MinCapacity, once Pops pops in a row left the
+// buffer less than LowPercent full. A buffer already below MinCapacity keeps
+// its capacity.
+template<size_t LowPercent = 25, size_t Pops = 1024, size_t MinCapacity = 16>
+struct CircBuffHysteresisShrink {
+  static_assert(LowPercent <= 50, "shrinking above half occupancy would grow again right away");
+
+  static constexpr bool enabled = true;
+  static constexpr bool low(size_t size, size_t capacity) {
+    return size * 100 < capacity * LowPercent;
+  }
+  static constexpr size_t pops = Pops;
+  static constexpr size_t next(size_t capacity) {
+    return std::min(capacity, std::max(capacity / 2, MinCapacity));
+  }
+};
+
+// Counters and timings collected by CircBuffStats, plain data for export.
+struct CircBuffStatsSnapshot {
+  static constexpr size_t kReallocBuckets = 32;
+
+  uint64_t pushes = 0;  // elements stored, including those that overwrote older ones
+  uint64_t pops = 0;
+  uint64_t overwrites = 0;
+  uint64_t rejects = 0;
+  uint64_t grow_events = 0;
+  uint64_t shrink_events = 0;
+  uint64_t high_water = 0;  // largest size reached
+  uint64_t reallocations = 0;
+  uint64_t realloc_ns_total = 0;
+  // bucket i counts reallocations that took [2^i, 2^(i+1)) ns, the last one also everything longer
+  uint64_t realloc_ns_buckets[kReallocBuckets] = {};
+};
+
+// Instrumentation policies. The hooks of CircBuffNoStats are empty, so the
+// default buffers carry no counters and read no clocks.
+struct CircBuffNoStats {
+  static constexpr bool enabled = false;
+  void pushed(size_t, size_t) {}
+  void popped(size_t) {}
+  void overwrote(size_t) {}
+  void rejected(size_t) {}
+  void grew() {}
+  void shrank() {}
+  void size_changed(size_t) {}
+  void reallocation_started() {}
+  void reallocation_finished() {}
+};
+
+// Counts every operation and times reallocations into a log2 histogram.
+class CircBuffStats {
+ public:
+  static constexpr bool enabled = true;
+
+  void pushed(size_t n, size_t size) {
+    snapshot_.pushes += n;
+    size_changed(size);
+  }
+  void popped(size_t n) { snapshot_.pops += n; }
+  void overwrote(size_t n) { snapshot_.overwrites += n; }
+  void rejected(size_t n) { snapshot_.rejects += n; }
+  void grew() { ++snapshot_.grow_events; }
+  void shrank() { ++snapshot_.shrink_events; }
+  void size_changed(size_t size) {
+    snapshot_.high_water = std::max<uint64_t>(snapshot_.high_water, size);
+  }
+
+  void reallocation_started() {
+    started_ = std::chrono::steady_clock::now();
+  }
+
+  void reallocation_finished() {
+    const auto elapsed = std::chrono::steady_clock::now() - started_;
+    const auto ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    size_t bucket = 0;
+    while (bucket + 1 < CircBuffStatsSnapshot::kReallocBuckets && (ns >> (bucket + 1)) != 0) ++bucket;
+    ++snapshot_.reallocations;
+    snapshot_.realloc_ns_total += ns;
+    ++snapshot_.realloc_ns_buckets[bucket];
+  }
+
+  [[nodiscard]] const CircBuffStatsSnapshot& snapshot() const {
+    return snapshot_;
+  }
+
+  void reset() {
+    snapshot_ = CircBuffStatsSnapshot();
+  }
+
+ private:
+  CircBuffStatsSnapshot snapshot_;
+  std::chrono::steady_clock::time_point started_;
+};
+
+// Types whose objects may be moved to another address with memcpy, leaving
+// the source to be freed without running its destructor. Specialize for such
+// non-trivially copyable types (e.g. owning pointers) to enable the memcpy
+// relocation path.
+template<typename T>
+struct CircBuffTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+// Non-owning view of a contiguous run of elements, a minimal std::span.
+template<typename T>
+class CircBuffSpan {
+ public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using size_type = size_t;
+  using iterator = T*;
+
+  constexpr CircBuffSpan() = default;
+  constexpr CircBuffSpan(T* data, size_type size) : data_(data), size_(size) {}
+
+  [[nodiscard]] constexpr T* data() const { return data_; }
+  [[nodiscard]] constexpr size_type size() const { return size_; }
+  [[nodiscard]] constexpr size_type size_bytes() const { return size_ * sizeof(T); }
+  [[nodiscard]] constexpr bool empty() const { return size_ == 0; }
+  constexpr T* begin() const { return data_; }
+  constexpr T* end() const { return data_ + size_; }
+  constexpr T& operator[](size_type n) const { return data_[n]; }
+
+ private:
+  T* data_ = nullptr;
+  size_type size_ = 0;
+};
 
 class const_iterator;
-template<typename T, typename Allocator = std::allocator<T>>
+template<typename T, typename Allocator = std::allocator<T>, typename CapacityPolicy = CircBuffModuloCapacity,
+    CircBuffOnFull OnFull = CircBuffOnFull::overwrite, typename Stats = CircBuffNoStats>
 class CircBuff {
+  static_assert(OnFull != CircBuffOnFull::block, "CircBuff is single-threaded, use CircBuffSpsc or CircBuffMpmc to block");
+
  public:
   using value_type = T;
   using reference = T&;
@@ -12,127 +237,96 @@ class CircBuff {
   using difference_type = int32_t;
   using size_type = size_t;
   using iterator_category = std::random_access_iterator_tag;
+  using allocator_type = Allocator;
 
-  enum IteratorStatus {
-    begin_it, // just returned from begin()
-    end_it, // just returned from end()
-    regular_it // others
-  };
-
+  // Iterator is a buffer pointer plus a logical offset from head_, so ordering,
+  // distance and indexing follow element order even when the data wraps.
   template<typename ReturnedValueT>
-  class CircBuffIterator : public std::iterator<ReturnedValueT, iterator_category> {
+  class CircBuffIterator {
    public:
-    using value_type = ReturnedValueT;
+    using value_type = T;
+    using difference_type = CircBuff::difference_type;
+    using pointer = ReturnedValueT*;
+    using reference = ReturnedValueT&;
     using iterator_category = std::random_access_iterator_tag;
-    CircBuffIterator<ReturnedValueT>() = default;
-    explicit CircBuffIterator<ReturnedValueT>(T* pointer)
-        : pointer_(pointer), buff_begin_(nullptr), buff_capacity_(0), buff_end_(0) {}
-    CircBuffIterator<ReturnedValueT>(T* pointer, const CircBuff<T>& buff)
-        : pointer_(pointer), buff_begin_(buff.begin_), buff_capacity_(buff.capacity_), buff_end_(buff.end_) {}
-    CircBuffIterator<ReturnedValueT>(const CircBuffIterator& other)
-        : pointer_(other.pointer_),
-          buff_begin_(other.buff_begin_),
-          buff_capacity_(other.buff_capacity_),
-          buff_end_(other.buff_end_),
-          status_(other.status_) {}
-    ReturnedValueT& operator*() const { return *pointer_; }
+
+    CircBuffIterator() = default;
+    CircBuffIterator(const CircBuff* buff, size_type index) : buff_(buff), index_(index) {}
+    template<typename OtherValueT, typename = std::enable_if_t<std::is_const_v<ReturnedValueT>
+        && std::is_same_v<std::remove_const_t<ReturnedValueT>, OtherValueT>>>
+    CircBuffIterator(const CircBuffIterator<OtherValueT>& other) : buff_(other.buff_), index_(other.index_) {}
+
+    ReturnedValueT& operator*() const {
+      return buff_->element(index_);
+    }
     ReturnedValueT* operator->() const {
-      return pointer_;
+      return &buff_->element(index_);
     }
     ReturnedValueT& operator[](difference_type n) const {
-      return *(buff_begin_ + (pointer_ - buff_begin_ + n) % buff_capacity_);
+      return buff_->element(index_ + n);
     }
     bool operator>(const CircBuffIterator& rhs) const {
-      return pointer_ > rhs.pointer_;
+      return index_ > rhs.index_;
     }
     bool operator<(const CircBuffIterator& rhs) const {
-      return pointer_ < rhs.pointer_;
+      return index_ < rhs.index_;
     }
     bool operator>=(const CircBuffIterator& rhs) const {
-      return pointer_ >= rhs.pointer_;
+      return index_ >= rhs.index_;
     }
     bool operator<=(const CircBuffIterator& rhs) const {
-      return pointer_ <= rhs.pointer_;
+      return index_ <= rhs.index_;
     }
     bool operator==(const CircBuffIterator& it) const {
-      if (status_ == begin_it && it.status_ == end_it)
-        return false; // used for cycling in loops to prevent begin() == end()
-
-      return (pointer_ == it.pointer_);
+      return index_ == it.index_;
     }
     bool operator!=(const CircBuffIterator& it) const {
-      if (status_ == begin_it && it.status_ == end_it)
-        return true; // used for cycling in loops to prevent begin() == end()
-
-      return pointer_ != it.pointer_;
+      return index_ != it.index_;
     }
-    const CircBuffIterator<ReturnedValueT> operator++(int) {
-      CircBuffIterator<ReturnedValueT> Temp = *this;
-      if (pointer_ + 1 != buff_end_) ++pointer_;
-      else pointer_ = buff_begin_;
-      Temp.status_ = regular_it;
-      status_ = regular_it;
-
-      return Temp;
+    CircBuffIterator operator++(int) {
+      CircBuffIterator temp = *this;
+      ++index_;
+      return temp;
     }
-    const CircBuffIterator<ReturnedValueT> operator--(int) {
-      CircBuffIterator<ReturnedValueT> Temp = *this;
-      if (pointer_ - 1 != buff_begin_) --pointer_;
-      else pointer_ = buff_end_ - 1;
-      Temp.status_ = regular_it;
-      status_ = regular_it;
-
-      return Temp;
+    CircBuffIterator operator--(int) {
+      CircBuffIterator temp = *this;
+      --index_;
+      return temp;
     }
-    CircBuffIterator<ReturnedValueT>& operator++() {
-      if (pointer_ + 1 == buff_end_) pointer_ = buff_begin_;
-      else ++pointer_;
-      status_ = regular_it;
-
+    CircBuffIterator& operator++() {
+      ++index_;
       return *this;
     }
-    CircBuffIterator<ReturnedValueT>& operator--() {
-      if (pointer_ - 1 >= buff_begin_) --pointer_;
-      else pointer_ = buff_end_ - 1;
-      status_ = regular_it;
-
+    CircBuffIterator& operator--() {
+      --index_;
       return *this;
     }
-    CircBuffIterator<ReturnedValueT> operator+(difference_type n) const {
-      CircBuffIterator<ReturnedValueT> result(*this);
-      result.pointer_ = (buff_begin_ + (pointer_ - buff_begin_ + n) % buff_capacity_);
-      return result;
+    CircBuffIterator operator+(difference_type n) const {
+      return CircBuffIterator(buff_, index_ + n);
     }
-    CircBuffIterator<ReturnedValueT> operator-(difference_type n) const {
-      CircBuffIterator<ReturnedValueT> result(*this);
-      result.pointer_ = (buff_begin_ + (pointer_ - buff_begin_ + buff_capacity_ - n) % buff_capacity_);
-      return result;
+    CircBuffIterator operator-(difference_type n) const {
+      return CircBuffIterator(buff_, index_ - n);
     }
-    difference_type operator-(const CircBuffIterator<ReturnedValueT>& rhs) const {
-      return pointer_ - rhs.pointer_;
+    difference_type operator-(const CircBuffIterator& rhs) const {
+      return static_cast<difference_type>(index_ - rhs.index_);
     }
-    CircBuffIterator<ReturnedValueT>& operator+=(difference_type n) {
-      status_ = regular_it;
-      pointer_ = buff_begin_ + (pointer_ - buff_begin_ + n) % buff_capacity_;
-
+    CircBuffIterator& operator+=(difference_type n) {
+      index_ += n;
       return *this;
     }
-    CircBuffIterator<ReturnedValueT>& operator-=(difference_type n) {
-      status_ = regular_it;
-      pointer_ = buff_begin_ + (pointer_ - buff_begin_ + buff_capacity_ - n) % buff_capacity_;
-
+    CircBuffIterator& operator-=(difference_type n) {
+      index_ -= n;
       return *this;
     }
-    friend CircBuffIterator<ReturnedValueT> operator+(difference_type n, CircBuffIterator<ReturnedValueT> it) {
+    friend CircBuffIterator operator+(difference_type n, const CircBuffIterator& it) {
       return it + n;
     }
 
-    IteratorStatus status_ = regular_it;
    private:
-    size_t buff_capacity_ = 0;
-    T* buff_begin_ = nullptr;
-    T* buff_end_ = nullptr;
-    T* pointer_ = nullptr;
+    friend class CircBuff;
+
+    const CircBuff* buff_ = nullptr;
+    size_type index_ = 0;
   };
 
   using iterator = CircBuffIterator<T>;
@@ -140,103 +334,137 @@ class CircBuff {
 
   CircBuff() = default;
 
-  explicit CircBuff(size_type capacity) : capacity_(capacity) {
-    data_ = alloc_.allocate(capacity);
-    begin_ = data_;
-    end_ = data_ + capacity;
+  explicit CircBuff(const Allocator& alloc) : alloc_(alloc) {}
+
+  explicit CircBuff(size_type capacity, const Allocator& alloc = Allocator())
+      : capacity_(CapacityPolicy::round(capacity)), alloc_(alloc) {
+    allocate_storage();
   }
 
-  CircBuff(size_type capacity, const T& default_value) : capacity_(capacity) {
-    data_ = alloc_.allocate(capacity);
-    begin_ = data_;
-    end_ = data_ + capacity_;
-    for (size_t i = 0; i < capacity_; ++i) {
-      alloc_.construct(data_ + i, default_value);
+  CircBuff(size_type capacity, const T& default_value, const Allocator& alloc = Allocator())
+      : capacity_(CapacityPolicy::round(capacity)), alloc_(alloc) {
+    allocate_storage();
+    for (size_type i = 0; i < capacity; ++i) {
+      construct_back(default_value);
     }
-    size_ = capacity;
-    if (capacity_ != 0)
-      tail_ = size_ - 1;
   }
 
-  CircBuff(const std::initializer_list<T>& elements) {
-    if (elements.size() != 0) {
-      capacity_ = elements.size();
-      size_ = capacity_;
-      data_ = alloc_.allocate(capacity_);
-      begin_ = data_;
-      end_ = data_ + capacity_;
-      head_ = 0;
-      tail_ = size_ - 1;
-      std::uninitialized_copy(elements.begin(), elements.end(), data_);
+  CircBuff(const std::initializer_list<T>& elements, const Allocator& alloc = Allocator())
+      : CircBuff(elements.size(), alloc) {
+    for (const auto& el : elements) {
+      construct_back(el);
     }
   }
 
-  CircBuff(const iterator& range_start, const iterator& range_end) {
-    capacity_ = (range_end - 1) - range_start + 1;
-    size_ = capacity_;
-    data_ = alloc_.allocate(capacity_);
-    begin_ = data_;
-    end_ = data_ + capacity_;
-    head_ = 0;
-    tail_ = size_ - 1;
-    size_t i = 0;
-    for (auto it = range_start; it != range_end; ++it, ++i) {
-      alloc_.construct(data_ + i, *it);
+  CircBuff(const iterator& range_start, const iterator& range_end, const Allocator& alloc = Allocator())
+      : CircBuff(range_end - range_start, alloc) {
+    for (auto it = range_start; it != range_end; ++it) {
+      construct_back(*it);
     }
   }
 
   CircBuff(const CircBuff& other)
-      : capacity_(other.capacity_), size_(other.size_), head_(other.head_), tail_(other.tail_) {
-    alloc_ = other.alloc_;
-    data_ = alloc_.allocate(capacity_);
-    std::uninitialized_copy(other.begin_, other.end_, data_);
-    begin_ = data_;
-    end_ = data_ + capacity_;
+      : CircBuff(other, AllocTraits::select_on_container_copy_construction(other.alloc_)) {}
+
+  CircBuff(const CircBuff& other, const Allocator& alloc) : capacity_(other.capacity_), alloc_(alloc) {
+    allocate_storage();
+    copy_from(other);
   }
 
-  ~CircBuff() {
-    for (size_t i = 0; i < capacity_; ++i) {
-      alloc_.destroy(data_ + i);
+  CircBuff(CircBuff&& other) noexcept
+      : capacity_(other.capacity_),
+        size_(other.size_),
+        tail_(other.tail_),
+        head_(other.head_),
+        overwritten_(other.overwritten_),
+        rejected_(other.rejected_),
+        stats_(std::move(other.stats_)),
+        begin_(other.begin_),
+        end_(other.end_),
+        data_(other.data_),
+        alloc_(std::move(other.alloc_)) {
+    other.capacity_ = 0;
+    other.size_ = 0;
+    other.tail_ = 0;
+    other.head_ = 0;
+    other.overwritten_ = 0;
+    other.rejected_ = 0;
+    other.stats_ = Stats();
+    other.begin_ = nullptr;
+    other.end_ = nullptr;
+    other.data_ = nullptr;
+  }
+
+  // Takes over the block of other when the allocators compare equal,
+  // otherwise moves the elements one by one into storage from alloc.
+  CircBuff(CircBuff&& other, const Allocator& alloc) : alloc_(alloc) {
+    if (alloc_ == other.alloc_) {
+      swap_contents(other);
+    } else {
+      capacity_ = other.capacity_;
+      allocate_storage();
+      move_from(other);
     }
-    alloc_.deallocate(data_, capacity_);
   }
 
-  iterator begin() const {
-    if (capacity_ == 0) return iterator();
-    iterator result(begin_ + head_, *this);
-    result.status_ = begin_it;
+  ~CircBuff() {
+    release();
+  }
 
-    return result;
+  iterator begin() const {
+    return iterator(this, 0);
   }
 
   iterator end() const {
-    if (capacity_ == 0) return iterator();
-    iterator result(begin_ + (tail_ + 1) % capacity_, *this);
-    result.status_ = end_it;
-
-    return result;
+    return iterator(this, size_);
   }
 
   const_iterator cbegin() const {
-    if (capacity_ == 0) return const_iterator();
-    const_iterator result(begin_ + head_, *this);
-    result.status_ = begin_it;
-
-    return result;
+    return const_iterator(this, 0);
   }
 
   const_iterator cend() const {
-    if (capacity_ == 0) return const_iterator();
-    const_iterator result(begin_ + (tail_ + 1) % capacity_, *this);
-    result.status_ = end_it;
-
-    return result;
+    return const_iterator(this, size_);
   }
 
   [[nodiscard]] bool empty() const {
     return size_ == 0;
   }
 
+  // Live elements from head_ up to the end of storage or the tail.
+  CircBuffSpan<T> array_one() {
+    return CircBuffSpan<T>(begin_ + head_, first_segment_size());
+  }
+
+  CircBuffSpan<const T> array_one() const {
+    return CircBuffSpan<const T>(begin_ + head_, first_segment_size());
+  }
+
+  // Live elements that wrapped around to the start of storage, empty if none.
+  CircBuffSpan<T> array_two() {
+    return CircBuffSpan<T>(begin_, size_ - first_segment_size());
+  }
+
+  CircBuffSpan<const T> array_two() const {
+    return CircBuffSpan<const T>(begin_, size_ - first_segment_size());
+  }
+
+  // Moves the live elements so that they start at the first slot, after that
+  // array_one() covers the whole contents. Works within the current block.
+  CircBuffSpan<T> linearize() {
+    if (!is_linearized()) {
+      if (size_ != capacity_) close_free_slots();
+      std::rotate(begin_, begin_ + head_, begin_ + size_);
+      head_ = 0;
+      tail_ = size_ - 1;
+    }
+    return array_one();
+  }
+
+  [[nodiscard]] bool is_linearized() const {
+    return head_ + size_ <= capacity_;
+  }
+
   [[nodiscard]] size_type size() const {
     return size_;
   }
@@ -246,301 +474,672 @@ class CircBuff {
   }
 
   [[nodiscard]] size_type max_size() const {
-    return alloc_.max_size();
+    return AllocTraits::max_size(alloc_);
+  }
+
+  allocator_type get_allocator() const {
+    return alloc_;
   }
 
+  // The allocator of other is taken only if propagate_on_container_copy_assignment
+  // says so. The block is reused when it has the right size and allocator.
   CircBuff& operator=(const CircBuff& other) {
     if (this != &other) { // avoiding self copy
-      if (data_ != nullptr) {
-        for (size_t i = 0; i < capacity_; ++i) {
-          alloc_.destroy(data_ + i);
+      constexpr bool kPropagate = AllocTraits::propagate_on_container_copy_assignment::value;
+      if (capacity_ == other.capacity_ && (!kPropagate || alloc_ == other.alloc_)) {
+        clear();
+        copy_from(other);
+      } else {
+        CircBuff copy(other, kPropagate ? other.alloc_ : alloc_);
+        swap_contents(copy);
+        if constexpr (kPropagate) {
+          std::swap(alloc_, copy.alloc_);
         }
-        alloc_.deallocate(data_, capacity_);
       }
-      alloc_ = other.alloc_;
-      capacity_ = other.capacity_;
-      data_ = alloc_.allocate(capacity_);
-      if (other.data_ != nullptr) std::uninitialized_copy(other.begin(), other.end(), data_);
-      begin_ = data_;
-      end_ = data_ + capacity_;
-      size_ = other.size_;
-      head_ = other.head_;
-      tail_ = other.tail_;
     }
 
     return *this;
   }
-  value_type& operator[](size_type n) {
-    return *(data_ + n % size_);
-  }
 
-  CircBuff& operator=(std::initializer_list<T> elements) {
-    if (data_ != nullptr) {
-      for (size_t i = 0; i < capacity_; ++i) {
-        alloc_.destroy(data_ + i);
+  // Without propagate_on_container_move_assignment an unequal allocator keeps
+  // its own storage and the elements are moved over one by one.
+  CircBuff& operator=(CircBuff&& other) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                                 || AllocTraits::is_always_equal::value) {
+    if (this != &other) {
+      if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+        CircBuff moved(std::move(other));
+        swap_contents(moved);
+        std::swap(alloc_, moved.alloc_);
+      } else {
+        CircBuff moved(std::move(other), alloc_);
+        swap_contents(moved);
       }
-      alloc_.deallocate(data_, capacity_);
     }
-    capacity_ = elements.size();
-    size_ = capacity_;
-    data_ = alloc_.allocate(capacity_);
-    begin_ = data_;
-    end_ = data_ + capacity_;
-    head_ = 0;
-    if (elements.size() != 0) {
-      tail_ = size_ - 1;
-      std::uninitialized_copy(elements.begin(), elements.end(), data_);
-    } else tail_ = 0;
 
     return *this;
   }
 
-  virtual void push(const T& el) {
-    if (capacity_ == 0) throw std::runtime_error("push to capacity=0 buffer");
-    if (!empty()) {
-      tail_ = (++tail_) % capacity_;
-      if (head_ == tail_) head_ = (++head_) % capacity_;
+  value_type& operator[](size_type n) {
+    return element(n);
+  }
+
+  const value_type& operator[](size_type n) const {
+    return element(n);
+  }
+
+  CircBuff& operator=(std::initializer_list<T> elements) {
+    return *this = CircBuff(elements, alloc_);
+  }
+
+  void push(const T& el) {
+    put(el);
+  }
+
+  void push(T&& el) {
+    put(std::move(el));
+  }
+
+  // constructs in place unless the buffer is full and the oldest is overwritten
+  template<typename... Args>
+  void emplace(Args&& ... args) {
+    if (size_ < capacity_) {
+      construct_back(std::forward<Args>(args)...);
+      stats_.pushed(1, size_);
+    } else if constexpr (OnFull == CircBuffOnFull::reject) {
+      reject(1);
+    } else {
+      put(T(std::forward<Args>(args)...));
     }
-    *(begin_ + tail_) = el;
-    if (size_ < capacity_) ++size_;
+  }
+
+  // Pushes only into a free slot, whatever the full-buffer policy.
+  // Returns false and counts a rejection when the buffer is full.
+  bool try_push(const T& el) {
+    return try_put(el);
+  }
+
+  bool try_push(T&& el) {
+    return try_put(std::move(el));
   }
 
   void pop() {
     if (empty()) throw std::runtime_error("pop from empty buffer");
-    head_ = (++head_) % capacity_;
-    if (size_ > 0) --size_;
+    AllocTraits::destroy(alloc_, begin_ + head_);
+    head_ = CapacityPolicy::wrap(head_ + 1, capacity_);
+    --size_;
+    stats_.popped(1);
+  }
+
+  // drops the newest element
+  void pop_back() {
+    if (empty()) throw std::runtime_error("pop from empty buffer");
+    AllocTraits::destroy(alloc_, &element(size_ - 1));
+    --size_;
+    tail_ = empty() ? head_ : CapacityPolicy::wrap(head_ + size_ - 1, capacity_);
+    stats_.popped(1);
+  }
+
+  // moves the oldest element into out and pops it
+  void pop_into(T& out) {
+    if (empty()) throw std::runtime_error("pop from empty buffer");
+    out = std::move(*(begin_ + head_));
+    pop();
+  }
+
+  bool try_pop(T& out) {
+    if (empty()) return false;
+    pop_into(out);
+    return true;
+  }
+
+  // Pushes n elements in at most two contiguous copies around the wrap point.
+  // Like push, overwrites the oldest elements or drops the last items when
+  // there is not enough room.
+  void push_n(const T* items, size_type n) {
+    if (n == 0) return;
+    if (capacity_ == 0) throw std::runtime_error("push to capacity=0 buffer");
+    if constexpr (OnFull == CircBuffOnFull::reject) {
+      const size_type dropped = n - std::min(n, capacity_ - size_);
+      rejected_ += dropped;
+      stats_.rejected(dropped);
+      n -= dropped;
+    } else if (n > capacity_) {
+      overwritten_ += n - capacity_;
+      stats_.pushed(n - capacity_, size_);
+      stats_.overwrote(n - capacity_);
+      items += n - capacity_;
+      n = capacity_;
+    }
+    // free slots are constructed, the rest are assigned over the oldest elements
+    const size_type fresh = std::min(n, capacity_ - size_);
+    overwritten_ += n - fresh;
+    for_each_run(size_, fresh, [&](T* to, size_type done, size_type run) {
+      construct_n(items + done, run, to);
+    });
+    for_each_run(size_ + fresh, n - fresh, [&](T* to, size_type done, size_type run) {
+      copy_n(items + fresh + done, run, to);
+    });
+    head_ = CapacityPolicy::wrap(head_ + n - fresh, capacity_);
+    size_ += fresh;
+    tail_ = CapacityPolicy::wrap(head_ + size_ - 1, capacity_);
+    stats_.pushed(n, size_);
+    stats_.overwrote(n - fresh);
+  }
+
+  // Moves up to n oldest elements to out in at most two contiguous copies.
+  // Returns the number of elements popped.
+  size_type pop_n(T* out, size_type n) {
+    n = std::min(n, size_);
+    if (n == 0) return 0;
+    for_each_run(0, n, [&](T* from, size_type done, size_type run) {
+      move_n(from, run, out + done);
+      destroy_n(from, run);
+    });
+    head_ = CapacityPolicy::wrap(head_ + n, capacity_);
+    size_ -= n;
+    stats_.popped(n);
+    return n;
+  }
+
+  // Hands up to max_n oldest elements to callback, then drops them with a
+  // single update of head_ and size_. A callback taking T& gets one element
+  // per call, otherwise it gets each contiguous run as a CircBuffSpan<T>, at
+  // most two calls. If the callback throws, what it was already given is
+  // dropped and the rest stays. Returns the number of elements consumed.
+  template<typename Callback>
+  size_type consume(size_type max_n, Callback&& callback) {
+    const size_type n = std::min(max_n, size_);
+    size_type done = 0;
+    try {
+      for_each_run(0, n, [&](T* first, size_type, size_type run) {
+        if constexpr (std::is_invocable_v<Callback&, T&>) {
+          for (size_type i = 0; i < run; ++i, ++done) {
+            callback(first[i]);
+          }
+        } else {
+          callback(CircBuffSpan<T>(first, run));
+          done += run;
+        }
+      });
+    } catch (...) {
+      drop_front(done);
+      throw;
+    }
+    drop_front(n);
+    return n;
+  }
+
+  template<typename Callback>
+  size_type consume_all(Callback&& callback) {
+    return consume(size_, std::forward<Callback>(callback));
   }
 
   void reserve(size_type new_capacity) {
+    new_capacity = CapacityPolicy::round(new_capacity);
     if (new_capacity > capacity_) {
-      T* new_data = alloc_.allocate(new_capacity);
-      for (size_t i = 0; i < size_; ++i) {
-        alloc_.construct(new_data + i, *(begin_ + i));
-        alloc_.destroy(begin_ + i);
-      }
-      alloc_.deallocate(data_, capacity_);
-      capacity_ = new_capacity;
-      data_ = new_data;
-      begin_ = data_;
-      end_ = data_ + capacity_;
+      relocate(new_capacity, size_, 0);
+      if (!empty()) tail_ = size_ - 1;
     }
   }
 
   void resize(size_type new_capacity, const T& default_value = T()) {
+    new_capacity = CapacityPolicy::round(new_capacity);
     if (new_capacity == capacity_) return;
-    T* new_data = alloc_.allocate(new_capacity);
-    size_t i = 0;
-    size_t new_size = 0;
-    for (auto it = begin(); it != end() && new_size < new_capacity; ++it, ++i, ++new_size) {
-      alloc_.construct(new_data + i, *it);
+    stats_.reallocation_started();
+    T* new_data = new_capacity == 0 ? nullptr : AllocTraits::allocate(alloc_, new_capacity);
+    const size_type kept = std::min(size_, new_capacity);
+    for (size_type i = 0; i < kept; ++i) {
+      AllocTraits::construct(alloc_, new_data + i, std::move_if_noexcept(element(i)));
     }
-    for (i = size_; i < new_capacity; ++i) {
-      alloc_.construct(new_data + i, default_value);
-      ++new_size;
+    for (size_type i = kept; i < new_capacity; ++i) {
+      AllocTraits::construct(alloc_, new_data + i, default_value);
     }
-    for (size_t j = 0; j < capacity_; ++j) {
-      alloc_.destroy(data_ + j);
-    }
-    alloc_.deallocate(data_, capacity_);
-    data_ = new_data;
-    capacity_ = new_capacity;
-    begin_ = data_;
-    end_ = data_ + capacity_;
-    head_ = 0;
-    size_ = new_size;
-    if (size_ != 0) tail_ = size_ - 1;
+    adopt(new_data, new_capacity);
+    size_ = new_capacity;
+    tail_ = size_ != 0 ? size_ - 1 : 0;
+    stats_.reallocation_finished();
+    stats_.size_changed(size_);
   }
 
   iterator insert(const iterator& it, const value_type& value) {
-    bool found = false;
-    size_type new_capacity = capacity_;
-    if (size_ == capacity_) ++new_capacity;
-    T* new_data = alloc_.allocate(new_capacity);
-    size_t i = 0;
-    iterator result;
-    for (auto cur = begin(); cur != end() && i < new_capacity; ++cur) {
-      if (cur == it && i == 0 && !found) {
-        found = true;
-        alloc_.construct(new_data + i, value);
-        result = iterator(new_data + i);
-        ++i;
-      }
-      alloc_.construct(new_data + i, *cur);
-      ++i;
-      if (cur + 1 == it && !found) {
-        found = true;
-        alloc_.construct(new_data + i, value);
-        result = iterator(new_data + i);
-        ++i;
-      }
-    }
-    if (!found) {
-      throw std::runtime_error("cannot insert before not found iterator");
-    }
-    for (size_t j = 0; j < capacity_; ++j) {
-      alloc_.destroy(data_ + j);
-    }
-    alloc_.deallocate(data_, capacity_);
-    capacity_ = new_capacity;
-    data_ = new_data;
-    begin_ = data_;
-    end_ = data_ + capacity_;
-    ++size_;
-    head_ = 0;
-    tail_ = size_ - 1;
-    return result;
+    return insert(it, 1, value);
   }
 
   iterator insert(const iterator& it, size_type n, const value_type& value) {
-    iterator before = it;
-    iterator result = it;
-    bool first_inserted = false;
-    for (size_t i = 0; i < n; ++i) {
-      before = insert(before, value);
-      if (!first_inserted) result = before;
-      first_inserted = true;
+    const size_type pos = position_of(it, "cannot insert before not found iterator");
+    open_gap(pos, n);
+    for (size_type i = 0; i < n; ++i) {
+      AllocTraits::construct(alloc_, &element(pos + i), value);
     }
-    return result;
+    return iterator_at(pos);
   }
 
   iterator insert(const iterator& it, const iterator& range_start, const iterator& range_end) {
-    iterator before = it;
-    iterator result = it;
-    bool first_inserted = false;
-    size_t i = 0;
-    for (auto range_val = range_end - 1; i <= (range_end - 1 - range_start); --range_val, ++i) {
-      before = insert(before, *range_val);
-      if (!first_inserted) result = before;
-      first_inserted = true;
+    const size_type pos = position_of(it, "cannot insert before not found iterator");
+    const size_type n = range_end - range_start;
+    open_gap(pos, n);
+    size_type i = pos;
+    for (auto cur = range_start; i < pos + n; ++cur, ++i) {
+      AllocTraits::construct(alloc_, &element(i), *cur);
     }
-    return result;
+    return iterator_at(pos);
   }
 
   iterator insert(const iterator& it, std::initializer_list<T> range) {
-    iterator before = it;
-    iterator result = it;
-    bool first_inserted = false;
-    size_t i = 0;
-    if (range.size() != 0) {
-      for (auto range_val = range.end() - 1; i < range.size(); --range_val, ++i) {
-        before = insert(before, *range_val);
-        if (!first_inserted) result = before;
-        first_inserted = true;
-      }
+    const size_type pos = position_of(it, "cannot insert before not found iterator");
+    open_gap(pos, range.size());
+    size_type i = pos;
+    for (const auto& el : range) {
+      AllocTraits::construct(alloc_, &element(i++), el);
     }
-    return result;
+    return iterator_at(pos);
   }
 
   iterator erase(const iterator& it) {
-    bool found = false;
-    T* new_data = alloc_.allocate(capacity_);
-    size_t i = 0;
-    iterator result = end();
-    for (auto cur = begin(); cur != end(); ++cur) {
-      if (cur == it && !found) {
-        found = true;
-        --size_;
-        result = cur + 1;
-      } else {
-        alloc_.construct(new_data + i, *cur);
-        ++i;
-      }
-    }
-    if (!found) {
-      throw std::runtime_error("cannot erase not found iterator");
-    }
-    for (size_t j = 0; j < capacity_; ++j) {
-      alloc_.destroy(data_ + j);
-    }
-    alloc_.deallocate(data_, capacity_);
-    data_ = new_data;
-    begin_ = data_;
-    end_ = data_ + capacity_;
-    head_ = 0;
-    if (!empty()) tail_ = size_ - 1;
-    else tail_ = 0;
-    return result;
+    const size_type pos = position_of(it, "cannot erase not found iterator");
+    if (pos == size_) throw std::runtime_error("cannot erase not found iterator");
+    close_gap(pos, 1);
+    return iterator_at(pos);
   }
 
   iterator erase(const iterator& range_start, const iterator& range_end) {
-    bool found = false;
-    T* new_data = alloc_.allocate(capacity_);
-    size_t i = 0;
-    iterator result = end();
-    for (auto cur = begin(); cur != end(); ++cur) {
-      if (cur == range_start) {
-        cur = range_end - 1;
-        size_ -= ((cur - range_start) + 1);
-        found = true;
-        result = cur + 1;
-      } else {
-        alloc_.construct(new_data + i, *cur);
-        ++i;
-      }
-    }
-    if (!found) {
-      throw std::runtime_error("cannot erase not found iterator");
-    }
-    for (size_t j = 0; j < capacity_; ++j) {
-      alloc_.destroy(data_ + j);
-    }
-    alloc_.deallocate(data_, capacity_);
-    data_ = new_data;
-    begin_ = data_;
-    end_ = data_ + capacity_;
-    head_ = 0;
-    if (!empty()) tail_ = size_ - 1;
-    else tail_ = 0;
-    return result;
+    const size_type first = position_of(range_start, "cannot erase not found iterator");
+    const size_type last = position_of(range_end, "cannot erase not found iterator");
+    if (first > last) throw std::runtime_error("cannot erase not found iterator");
+    close_gap(first, last - first);
+    return iterator_at(first);
   }
 
   void assign(const iterator& range_start, const iterator& range_end) {
-    *this = CircBuff<T, Allocator>(range_start, range_end);
+    *this = CircBuff(range_start, range_end, alloc_);
   }
   void assign(const std::initializer_list<T>& elements) {
-    *this = CircBuff<T, Allocator>(elements);
+    *this = CircBuff(elements, alloc_);
   }
   void assign(size_type capacity, const T& default_value) {
-    *this = CircBuff<T, Allocator>(capacity, default_value);
+    *this = CircBuff(capacity, default_value, alloc_);
   }
 
+  // Destroys the live elements only, so it is O(1) for trivially destructible T.
   void clear() {
-    for (size_t i = 0; i < capacity_; ++i) {
-      alloc_.destroy(data_ + i);
-    }
+    destroy_range(0, size_);
     head_ = 0;
     tail_ = 0;
     size_ = 0;
   }
 
+  // elements lost to overwriting and pushes dropped because the buffer was full
+  [[nodiscard]] size_type overwritten() const {
+    return overwritten_;
+  }
+
+  [[nodiscard]] size_type rejected() const {
+    return rejected_;
+  }
+
+  // the instrumentation policy, e.g. stats().snapshot() with CircBuffStats
+  [[nodiscard]] const Stats& stats() const {
+    return stats_;
+  }
+
+  // Allocators are exchanged only if propagate_on_container_swap says so,
+  // otherwise they have to compare equal.
   void swap(CircBuff& other) {
-    std::swap(alloc_, other.alloc_);
+    if constexpr (AllocTraits::propagate_on_container_swap::value) {
+      std::swap(alloc_, other.alloc_);
+    }
+    swap_contents(other);
+  }
+
+  friend void swap(CircBuff& lhs, CircBuff& rhs) {
+    lhs.swap(rhs);
+  }
+
+ protected:
+  // Only the size_ slots starting at head_ hold constructed objects, the rest
+  // of the block is raw storage.
+  using AllocTraits = std::allocator_traits<Allocator>;
+
+  // swaps everything but the allocators
+  void swap_contents(CircBuff& other) {
     std::swap(begin_, other.begin_);
     std::swap(end_, other.end_);
     std::swap(capacity_, other.capacity_);
     std::swap(size_, other.size_);
     std::swap(head_, other.head_);
     std::swap(tail_, other.tail_);
+    std::swap(overwritten_, other.overwritten_);
+    std::swap(rejected_, other.rejected_);
+    std::swap(stats_, other.stats_);
     std::swap(data_, other.data_);
   }
 
-  friend void swap(CircBuff& lhs, CircBuff& rhs) {
-    lhs.swap(rhs);
+  // logical position of it in [0, size_], end() maps to size_
+  size_type position_of(const iterator& it, const char* error) const {
+    if (it.buff_ != this || it.index_ > size_) throw std::runtime_error(error);
+    return it.index_;
+  }
+
+  T& element(size_type pos) const {
+    return *(begin_ + CapacityPolicy::wrap(head_ + pos, capacity_));
+  }
+
+  iterator iterator_at(size_type pos) const {
+    return iterator(this, pos);
+  }
+
+  // Makes room for n elements before logical position pos, shifting whichever
+  // side is shorter. Reallocates once if the elements do not fit. The gap is
+  // left unconstructed for the caller to fill.
+  void open_gap(size_type pos, size_type n) {
+    if (n == 0) return;
+    if (size_ + n > capacity_) {
+      relocate(CapacityPolicy::round(size_ + n), pos, n);
+    } else if (pos < size_ - pos) {
+      head_ = CapacityPolicy::wrap(head_ + capacity_ - n, capacity_);
+      // elements now sit at [n, n + size_), the first ones move into free slots
+      const size_type fresh = std::min(n, pos);
+      for (size_type i = 0; i < fresh; ++i) {
+        AllocTraits::construct(alloc_, &element(i), std::move(element(i + n)));
+      }
+      shift(n + fresh, fresh, pos - fresh);
+      destroy_range(std::max(pos, n), pos + n);
+    } else {
+      const size_type fresh = std::min(n, size_ - pos);
+      for (size_type i = size_ - fresh; i < size_; ++i) {
+        AllocTraits::construct(alloc_, &element(i + n), std::move(element(i)));
+      }
+      shift(pos, pos + n, size_ - pos - fresh);
+      destroy_range(pos, std::min(pos + n, size_));
+    }
+    size_ += n;
+    tail_ = CapacityPolicy::wrap(head_ + size_ - 1, capacity_);
+    stats_.size_changed(size_);
+  }
+
+  // Removes n elements starting at logical position pos, shifting whichever
+  // side is shorter into their place.
+  void close_gap(size_type pos, size_type n) {
+    if (n == 0) return;
+    if (pos < size_ - pos - n) {
+      shift(0, n, pos);
+      destroy_range(0, n);
+      head_ = CapacityPolicy::wrap(head_ + n, capacity_);
+    } else {
+      shift(pos + n, pos, size_ - pos - n);
+      destroy_range(size_ - n, size_);
+    }
+    size_ -= n;
+    tail_ = empty() ? head_ : CapacityPolicy::wrap(head_ + size_ - 1, capacity_);
+  }
+
+  // Slides the first segment of a wrapped, not full buffer down against the
+  // second one, so the live elements fill [0, size_) with the oldest at
+  // head_. The free slots have no objects, the first moves construct there.
+  void close_free_slots() {
+    const size_type one = first_segment_size();
+    const size_type two = size_ - one;
+    T* from = begin_ + head_;
+    T* to = begin_ + two;
+    if constexpr (CircBuffTriviallyRelocatable<T>::value) {
+      // the old copies are abandoned, not destroyed
+      std::memmove(static_cast<void*>(to), from, one * sizeof(T));
+    } else {
+      const size_type fresh = std::min(one, head_ - two);
+      for (size_type i = 0; i < fresh; ++i) {
+        AllocTraits::construct(alloc_, to + i, std::move(from[i]));
+      }
+      std::move(from + fresh, from + one, to + fresh);
+      const size_type live_end = std::max(head_, size_);
+      destroy_n(begin_ + live_end, capacity_ - live_end);
+    }
+    head_ = two;
+  }
+
+  // Moves count elements from logical position from to logical position to,
+  // one contiguous run between wrap points at a time.
+  void shift(size_type from, size_type to, size_type count) {
+    if (from > to) {
+      while (count != 0) {
+        T* src = &element(from);
+        T* dst = &element(to);
+        const size_type run = std::min({count, static_cast<size_type>(end_ - src), static_cast<size_type>(end_ - dst)});
+        std::move(src, src + run, dst);
+        from += run;
+        to += run;
+        count -= run;
+      }
+    } else {
+      while (count != 0) {
+        T* src_last = &element(from + count - 1) + 1;
+        T* dst_last = &element(to + count - 1) + 1;
+        const size_type run = std::min({count, static_cast<size_type>(src_last - begin_),
+                                        static_cast<size_type>(dst_last - begin_)});
+        std::move_backward(src_last - run, src_last, dst_last);
+        count -= run;
+      }
+    }
+  }
+
+  // Calls op(slot, done, run) for each contiguous run of the count slots
+  // starting at logical position pos, at most twice.
+  template<typename Op>
+  void for_each_run(size_type pos, size_type count, Op op) const {
+    size_type done = 0;
+    while (done < count) {
+      T* first = &element(pos + done);
+      const size_type run = std::min(count - done, static_cast<size_type>(end_ - first));
+      op(first, done, run);
+      done += run;
+    }
+  }
+
+  // Moves the contents into a new block of new_capacity slots starting at the
+  // first slot, leaving n unconstructed slots before logical position pos.
+  // Trivially relocatable elements are copied with at most four memcpy calls.
+  void relocate(size_type new_capacity, size_type pos, size_type n) {
+    stats_.reallocation_started();
+    T* new_data = new_capacity == 0 ? nullptr : AllocTraits::allocate(alloc_, new_capacity);
+    if constexpr (CircBuffTriviallyRelocatable<T>::value) {
+      for_each_run(0, pos, [&](T* from, size_type done, size_type run) {
+        std::memcpy(static_cast<void*>(new_data + done), from, run * sizeof(T));
+      });
+      for_each_run(pos, size_ - pos, [&](T* from, size_type done, size_type run) {
+        std::memcpy(static_cast<void*>(new_data + pos + n + done), from, run * sizeof(T));
+      });
+      // the old copies are abandoned, not destroyed
+      replace_block(new_data, new_capacity);
+    } else {
+      for (size_type i = 0; i < size_; ++i) {
+        AllocTraits::construct(alloc_, new_data + (i < pos ? i : i + n), std::move_if_noexcept(element(i)));
+      }
+      adopt(new_data, new_capacity);
+    }
+    stats_.reallocation_finished();
+  }
+
+  // Frees the current block and switches to new_data, whose elements start at
+  // the first slot. size_ and tail_ are left to the caller.
+  void adopt(T* new_data, size_type new_capacity) {
+    destroy_range(0, size_);
+    replace_block(new_data, new_capacity);
+  }
+
+  void replace_block(T* new_data, size_type new_capacity) {
+    if (data_ != nullptr) AllocTraits::deallocate(alloc_, data_, capacity_);
+    data_ = new_data;
+    capacity_ = new_capacity;
+    begin_ = data_;
+    end_ = data_ + capacity_;
+    head_ = 0;
+  }
+
+  void allocate_storage() {
+    data_ = capacity_ == 0 ? nullptr : AllocTraits::allocate(alloc_, capacity_);
+    begin_ = data_;
+    end_ = data_ + capacity_;
+  }
+
+  void release() {
+    destroy_range(0, size_);
+    if (data_ != nullptr) AllocTraits::deallocate(alloc_, data_, capacity_);
+  }
+
+  // copies the contents of other to the start of this empty buffer
+  void copy_from(const CircBuff& other) {
+    const auto one = other.array_one();
+    const auto two = other.array_two();
+    construct_n(one.data(), one.size(), data_);
+    construct_n(two.data(), two.size(), data_ + one.size());
+    head_ = 0;
+    size_ = other.size_;
+    tail_ = size_ != 0 ? size_ - 1 : 0;
+    overwritten_ = other.overwritten_;
+    rejected_ = other.rejected_;
+    stats_ = other.stats_;
+  }
+
+  // moves the contents of other to the start of this empty buffer, other keeps its moved-from elements
+  void move_from(CircBuff& other) {
+    other.for_each_run(0, other.size_, [&](T* from, size_type done, size_type run) {
+      for (size_type i = 0; i < run; ++i) {
+        AllocTraits::construct(alloc_, data_ + done + i, std::move(from[i]));
+      }
+    });
+    head_ = 0;
+    size_ = other.size_;
+    tail_ = size_ != 0 ? size_ - 1 : 0;
+    overwritten_ = other.overwritten_;
+    rejected_ = other.rejected_;
+    stats_ = other.stats_;
+  }
+
+  size_type first_segment_size() const {
+    return std::min(size_, capacity_ - head_);
+  }
+
+  // destroys the n oldest elements and advances head_ past them
+  void drop_front(size_type n) {
+    if (n == 0) return;
+    destroy_range(0, n);
+    head_ = CapacityPolicy::wrap(head_ + n, capacity_);
+    size_ -= n;
+    stats_.popped(n);
+  }
+
+  template<typename... Args>
+  void construct_back(Args&& ... args) {
+    const size_type slot = CapacityPolicy::wrap(head_ + size_, capacity_);
+    AllocTraits::construct(alloc_, begin_ + slot, std::forward<Args>(args)...);
+    tail_ = slot;
+    ++size_;
+  }
+
+  template<typename U>
+  void put(U&& el) {
+    if (capacity_ == 0) throw std::runtime_error("push to capacity=0 buffer");
+    if (size_ < capacity_) {
+      construct_back(std::forward<U>(el));
+      stats_.pushed(1, size_);
+    } else if constexpr (OnFull == CircBuffOnFull::reject) {
+      ++rejected_;
+      stats_.rejected(1);
+    } else {
+      // full: the oldest slot takes the new element
+      *(begin_ + head_) = std::forward<U>(el);
+      tail_ = head_;
+      head_ = CapacityPolicy::wrap(head_ + 1, capacity_);
+      ++overwritten_;
+      stats_.pushed(1, size_);
+      stats_.overwrote(1);
+    }
+  }
+
+  template<typename U>
+  bool try_put(U&& el) {
+    if (size_ == capacity_) {
+      ++rejected_;
+      stats_.rejected(1);
+      return false;
+    }
+    construct_back(std::forward<U>(el));
+    stats_.pushed(1, size_);
+    return true;
+  }
+
+  void reject(size_type n) {
+    if (capacity_ == 0) throw std::runtime_error("push to capacity=0 buffer");
+    rejected_ += n;
+    stats_.rejected(n);
+  }
+
+  void destroy_range(size_type from, size_type to) {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for_each_run(from, to - from, [&](T* first, size_type, size_type run) {
+        destroy_n(first, run);
+      });
+    }
+  }
+
+  void destroy_n(T* first, size_type n) {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (size_type i = 0; i < n; ++i) {
+        AllocTraits::destroy(alloc_, first + i);
+      }
+    }
+  }
+
+  // copy-constructs n elements into raw storage
+  void construct_n(const T* from, size_type n, T* to) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      if (n != 0) std::memcpy(to, from, n * sizeof(T));
+    } else {
+      for (size_type i = 0; i < n; ++i) {
+        AllocTraits::construct(alloc_, to + i, from[i]);
+      }
+    }
+  }
+
+  static void copy_n(const T* from, size_type n, T* to) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      if (n != 0) std::memcpy(to, from, n * sizeof(T));
+    } else {
+      std::copy(from, from + n, to);
+    }
+  }
+
+  static void move_n(T* from, size_type n, T* to) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      if (n != 0) std::memcpy(to, from, n * sizeof(T));
+    } else {
+      std::move(from, from + n, to);
+    }
   }
 
- protected:
   size_type capacity_ = 0;
   size_type size_ = 0;
   size_type tail_ = 0;
   size_type head_ = 0;
+  size_type overwritten_ = 0;
+  size_type rejected_ = 0;
+  [[no_unique_address]] Stats stats_;
   value_type* begin_ = nullptr;
   value_type* end_ = nullptr;
   value_type* data_ = nullptr;
   Allocator alloc_;
 };
 
-template<typename T, typename Allocator = std::allocator<T>>
-class CircBuffExtended : public CircBuff<T, Allocator> {
+template<typename T, typename Allocator = std::allocator<T>, typename CapacityPolicy = CircBuffModuloCapacity,
+    typename GrowthPolicy = CircBuffGrowth<>, typename ShrinkPolicy = CircBuffNoShrink,
+    typename Stats = CircBuffNoStats>
+class CircBuffExtended : public CircBuff<T, Allocator, CapacityPolicy, CircBuffOnFull::overwrite, Stats> {
+  using Base = CircBuff<T, Allocator, CapacityPolicy, CircBuffOnFull::overwrite, Stats>;
+  using AllocTraits = typename Base::AllocTraits;
+
+  static constexpr bool kIncremental = GrowthPolicy::moves_per_push != 0;
+  static constexpr bool kNothrowMoveAssign =
+      AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value;
+
  public:
   using value_type = T;
   using reference = T&;
@@ -549,50 +1148,515 @@ class CircBuffExtended : public CircBuff<T, Allocator> {
   using size_type = size_t;
   using iterator_category = std::random_access_iterator_tag;
 
-  using iterator = typename CircBuff<T, Allocator>::template CircBuffIterator<T>;
-  using const_iterator = typename CircBuff<T, Allocator>::template CircBuffIterator<const T>;
+  using iterator = typename Base::template CircBuffIterator<T>;
+  using const_iterator = typename Base::template CircBuffIterator<const T>;
+
+  CircBuffExtended() : Base() {};
+
+  explicit CircBuffExtended(const Allocator& alloc) : Base(alloc) {}
+
+  explicit CircBuffExtended(size_type capacity, const Allocator& alloc = Allocator()) : Base(capacity, alloc) {}
+
+  CircBuffExtended(size_type capacity, const T& default_value, const Allocator& alloc = Allocator())
+      : Base(capacity, default_value, alloc) {}
+
+  CircBuffExtended(const std::initializer_list<T>& elements, const Allocator& alloc = Allocator())
+      : Base(elements, alloc) {};
+
+  CircBuffExtended(const iterator& range_start, const iterator& range_end, const Allocator& alloc = Allocator())
+      : Base(range_start, range_end, alloc) {};
 
-  CircBuffExtended() : CircBuff<T, Allocator>() {};
+  explicit CircBuffExtended(const Base& other) : Base(other) {}
 
-  explicit CircBuffExtended(size_type capacity) : CircBuff<T, Allocator>(capacity) {}
+  CircBuffExtended(const Base& other, const Allocator& alloc) : Base(other, alloc) {}
 
-  CircBuffExtended(size_type capacity, const T& default_value) : CircBuff<T, Allocator>(capacity, default_value) {}
+  CircBuffExtended(const CircBuffExtended& other)
+      : Base(other.settled()),
+        low_pops_(other.low_pops_),
+        grow_events_(other.grow_events_),
+        shrink_events_(other.shrink_events_) {}
 
-  CircBuffExtended(const std::initializer_list<T>& elements) : CircBuff<T, Allocator>(elements) {};
+  // takes over a pending growth together with the blocks
+  CircBuffExtended(CircBuffExtended&& other) noexcept
+      : Base(std::move(other)),
+        low_pops_(other.low_pops_),
+        grow_events_(other.grow_events_),
+        shrink_events_(other.shrink_events_),
+        old_data_(other.old_data_),
+        old_capacity_(other.old_capacity_),
+        old_head_(other.old_head_),
+        pending_(other.pending_) {
+    other.old_data_ = nullptr;
+    other.old_capacity_ = 0;
+    other.old_head_ = 0;
+    other.pending_ = 0;
+  }
+
+  ~CircBuffExtended() {
+    release_pending();
+  }
 
-  CircBuffExtended(const iterator& range_start, const iterator& range_end) : CircBuff<T, Allocator>(range_start,
-                                                                                                    range_end) {};
+  CircBuffExtended& operator=(const CircBuffExtended& other) {
+    if (this == &other) return *this;
+    settle();
+    Base::operator=(other.settled());
+    low_pops_ = other.low_pops_;
+    grow_events_ = other.grow_events_;
+    shrink_events_ = other.shrink_events_;
+    return *this;
+  }
 
-  explicit CircBuffExtended(const CircBuff<T, Allocator>& other) : CircBuff<T, Allocator>(other) {}
+  // Takes over the blocks of other, a pending growth included, when the
+  // allocator allows it, like the base class does.
+  CircBuffExtended& operator=(CircBuffExtended&& other) noexcept(kNothrowMoveAssign) {
+    if (this == &other) return *this;
+    if constexpr (kNothrowMoveAssign) {
+      CircBuffExtended moved(std::move(other));
+      if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+        std::swap(Base::alloc_, moved.alloc_);
+      }
+      Base::swap_contents(moved);
+      swap_growth(moved);
+    } else {
+      settle();
+      other.settle();
+      Base::operator=(std::move(other));
+      low_pops_ = other.low_pops_;
+      grow_events_ = other.grow_events_;
+      shrink_events_ = other.shrink_events_;
+    }
+    return *this;
+  }
+
+  iterator begin() const {
+    settled();
+    return Base::begin();
+  }
+
+  iterator end() const {
+    settled();
+    return Base::end();
+  }
+
+  const_iterator cbegin() const {
+    settled();
+    return Base::cbegin();
+  }
+
+  const_iterator cend() const {
+    settled();
+    return Base::cend();
+  }
+
+  [[nodiscard]] bool empty() const {
+    return size() == 0;
+  }
+
+  [[nodiscard]] size_type size() const {
+    return pending_ + Base::size_;
+  }
+
+  CircBuffSpan<T> array_one() {
+    settle();
+    return Base::array_one();
+  }
+
+  CircBuffSpan<const T> array_one() const {
+    settled();
+    return Base::array_one();
+  }
+
+  CircBuffSpan<T> array_two() {
+    settle();
+    return Base::array_two();
+  }
+
+  CircBuffSpan<const T> array_two() const {
+    settled();
+    return Base::array_two();
+  }
+
+  CircBuffSpan<T> linearize() {
+    settle();
+    return Base::linearize();
+  }
+
+  [[nodiscard]] bool is_linearized() const {
+    settled();
+    return Base::is_linearized();
+  }
+
+  value_type& operator[](size_type n) {
+    settle();
+    return Base::operator[](n);
+  }
+
+  const value_type& operator[](size_type n) const {
+    settled();
+    return Base::operator[](n);
+  }
 
   void push(const T& el) {
-    if (CircBuff<T, Allocator>::size() + 1 > CircBuff<T, Allocator>::capacity_) {
-      size_type new_capacity;
-      if (CircBuff<T, Allocator>::capacity_ == 0) new_capacity = 1;
-      else new_capacity = CircBuff<T, Allocator>::capacity_ * 2;
-      value_type* new_data = CircBuff<T, Allocator>::alloc_.allocate(new_capacity);
-      size_t i = 0;
-      for (auto it = CircBuff<T, Allocator>::begin(); it != CircBuff<T, Allocator>::end(); ++it, ++i) {
-        CircBuff<T, Allocator>::alloc_.construct(new_data + i, *it);
+    grow_if_full();
+    Base::push(el);
+    pushed();
+  }
+
+  void push(T&& el) {
+    grow_if_full();
+    Base::push(std::move(el));
+    pushed();
+  }
+
+  template<typename... Args>
+  void emplace(Args&& ... args) {
+    grow_if_full();
+    Base::emplace(std::forward<Args>(args)...);
+    pushed();
+  }
+
+  bool try_push(const T& el) {
+    grow_if_full();
+    const bool stored = Base::try_push(el);
+    pushed();
+    return stored;
+  }
+
+  bool try_push(T&& el) {
+    grow_if_full();
+    const bool stored = Base::try_push(std::move(el));
+    pushed();
+    return stored;
+  }
+
+  void push_n(const T* items, size_type n) {
+    settle();
+    grow_to(size() + n);
+    Base::push_n(items, n);
+  }
+
+  void pop() {
+    if (pending_ != 0) {
+      pop_pending();
+    } else {
+      Base::pop();
+    }
+    popped(1);
+  }
+
+  void pop_back() {
+    if (Base::size_ == 0) settle();
+    Base::pop_back();
+  }
+
+  void pop_into(T& out) {
+    if (pending_ != 0) {
+      out = std::move(old_data_[old_head_]);
+      pop_pending();
+    } else {
+      Base::pop_into(out);
+    }
+    popped(1);
+  }
+
+  bool try_pop(T& out) {
+    if (empty()) return false;
+    pop_into(out);
+    return true;
+  }
+
+  size_type pop_n(T* out, size_type n) {
+    settle();
+    n = Base::pop_n(out, n);
+    popped(n);
+    return n;
+  }
+
+  template<typename Callback>
+  size_type consume(size_type max_n, Callback&& callback) {
+    settle();
+    const size_type n = Base::consume(max_n, std::forward<Callback>(callback));
+    popped(n);
+    return n;
+  }
+
+  template<typename Callback>
+  size_type consume_all(Callback&& callback) {
+    return consume(size(), std::forward<Callback>(callback));
+  }
+
+  void reserve(size_type new_capacity) {
+    settle();
+    Base::reserve(new_capacity);
+  }
+
+  void resize(size_type new_capacity, const T& default_value = T()) {
+    settle();
+    Base::resize(new_capacity, default_value);
+  }
+
+  iterator insert(const iterator& it, const value_type& value) {
+    settle();
+    return Base::insert(it, value);
+  }
+
+  iterator insert(const iterator& it, size_type n, const value_type& value) {
+    settle();
+    return Base::insert(it, n, value);
+  }
+
+  iterator insert(const iterator& it, const iterator& range_start, const iterator& range_end) {
+    settle();
+    return Base::insert(it, range_start, range_end);
+  }
+
+  iterator insert(const iterator& it, std::initializer_list<T> range) {
+    settle();
+    return Base::insert(it, range);
+  }
+
+  iterator erase(const iterator& it) {
+    settle();
+    return Base::erase(it);
+  }
+
+  iterator erase(const iterator& range_start, const iterator& range_end) {
+    settle();
+    return Base::erase(range_start, range_end);
+  }
+
+  void assign(const iterator& range_start, const iterator& range_end) {
+    settle();
+    Base::assign(range_start, range_end);
+  }
+
+  void assign(const std::initializer_list<T>& elements) {
+    settle();
+    Base::assign(elements);
+  }
+
+  void assign(size_type capacity, const T& default_value) {
+    settle();
+    Base::assign(capacity, default_value);
+  }
+
+  void clear() {
+    settle();
+    Base::clear();
+  }
+
+  void swap(CircBuffExtended& other) {
+    settle();
+    other.settle();
+    Base::swap(other);
+    std::swap(low_pops_, other.low_pops_);
+    std::swap(grow_events_, other.grow_events_);
+    std::swap(shrink_events_, other.shrink_events_);
+  }
+
+  friend void swap(CircBuffExtended& lhs, CircBuffExtended& rhs) {
+    lhs.swap(rhs);
+  }
+
+  // Reallocates to the smallest capacity that holds the current elements.
+  void shrink_to_fit() {
+    low_pops_ = 0;
+    resize_storage(CapacityPolicy::round(size()));
+  }
+
+  // Moves the elements still left in the previous block by an incremental
+  // growth, so the buffer holds one block again.
+  void finish_growth() {
+    migrate(pending_);
+  }
+
+  // true while an incremental growth has elements left in the previous block
+  [[nodiscard]] bool growing() const {
+    return pending_ != 0;
+  }
+
+  // number of reallocations to a larger or a smaller block so far
+  [[nodiscard]] size_type grow_events() const {
+    return grow_events_;
+  }
+
+  [[nodiscard]] size_type shrink_events() const {
+    return shrink_events_;
+  }
+
+ private:
+  void settle() {
+    if constexpr (kIncremental) {
+      if (pending_ != 0) finish_growth();
+    }
+  }
+
+  // A buffer with a pending growth has been pushed to, so it is never a const
+  // object and may be settled through a const access.
+  const CircBuffExtended& settled() const {
+    const_cast<CircBuffExtended*>(this)->settle();
+    return *this;
+  }
+
+  void grow_if_full() {
+    if constexpr (kIncremental) {
+      if (pending_ != 0) {
+        // enough moves to be done before the free slots run out
+        const size_type free = Base::capacity_ - size();
+        migrate(std::max(GrowthPolicy::moves_per_push, (pending_ + free - 1) / free));
+        return;
+      }
+      if (Base::size_ == Base::capacity_ && Base::size_ != 0 && start_growth()) return;
+    }
+    grow_to(size() + 1);
+  }
+
+  // the base counts only the elements in the new block while a growth is pending
+  void pushed() {
+    if constexpr (kIncremental) {
+      if (pending_ != 0) Base::stats_.size_changed(size());
+    }
+  }
+
+  void grow_to(size_type min_capacity) {
+    if (min_capacity <= Base::capacity_) return;
+    settle();
+    const size_type new_capacity = CapacityPolicy::round(GrowthPolicy::next(Base::capacity_, min_capacity));
+    if (new_capacity <= Base::capacity_) return;
+    resize_storage(new_capacity);
+  }
+
+  // Allocates the larger block and leaves the full contents of the current
+  // one pending. The first pending_ slots of the new block are kept for them.
+  // Returns false, leaving the growth to grow_to(), when the pushed element
+  // would take the last free slot and leave no later push to move them.
+  bool start_growth() {
+    const size_type new_capacity = CapacityPolicy::round(GrowthPolicy::next(Base::capacity_, Base::size_ + 1));
+    if (new_capacity <= Base::size_ + 1) return false;
+    ++grow_events_;
+    Base::stats_.grew();
+    Base::stats_.reallocation_started();
+    T* new_data = AllocTraits::allocate(Base::alloc_, new_capacity);
+    old_data_ = Base::data_;
+    old_capacity_ = Base::capacity_;
+    old_head_ = Base::head_;
+    pending_ = Base::size_;
+    Base::data_ = new_data;
+    Base::begin_ = new_data;
+    Base::end_ = new_data + new_capacity;
+    Base::capacity_ = new_capacity;
+    Base::head_ = pending_;
+    Base::tail_ = Base::head_;
+    Base::size_ = 0;
+    Base::stats_.reallocation_finished();
+    return true;
+  }
+
+  // moves the newest n pending elements into the slots right before head_
+  void migrate(size_type n) {
+    n = std::min(n, pending_);
+    for (size_type i = 0; i < n; ++i) {
+      T* from = old_data_ + CapacityPolicy::wrap(old_head_ + pending_ - 1, old_capacity_);
+      T* to = Base::begin_ + Base::head_ - 1;
+      if constexpr (CircBuffTriviallyRelocatable<T>::value) {
+        std::memcpy(static_cast<void*>(to), from, sizeof(T));
+      } else {
+        AllocTraits::construct(Base::alloc_, to, std::move_if_noexcept(*from));
+        AllocTraits::destroy(Base::alloc_, from);
       }
-      for (size_t j = 0; j < CircBuff<T, Allocator>::capacity_; ++j) {
-        CircBuff<T, Allocator>::alloc_.destroy(CircBuff<T, Allocator>::data_ + j);
+      --pending_;
+      --Base::head_;
+      ++Base::size_;
+    }
+    if (pending_ == 0) release_pending();
+  }
+
+  // drops the oldest pending element, which is the oldest element of all
+  void pop_pending() {
+    AllocTraits::destroy(Base::alloc_, old_data_ + old_head_);
+    old_head_ = CapacityPolicy::wrap(old_head_ + 1, old_capacity_);
+    --pending_;
+    Base::stats_.popped(1);
+    if (pending_ == 0) release_pending();
+  }
+
+  // exchanges the counters and the state of a pending growth
+  void swap_growth(CircBuffExtended& other) {
+    std::swap(low_pops_, other.low_pops_);
+    std::swap(grow_events_, other.grow_events_);
+    std::swap(shrink_events_, other.shrink_events_);
+    std::swap(old_data_, other.old_data_);
+    std::swap(old_capacity_, other.old_capacity_);
+    std::swap(old_head_, other.old_head_);
+    std::swap(pending_, other.pending_);
+  }
+
+  void release_pending() {
+    if (old_data_ == nullptr) return;
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (size_type i = 0; i < pending_; ++i) {
+        AllocTraits::destroy(Base::alloc_, old_data_ + CapacityPolicy::wrap(old_head_ + i, old_capacity_));
+      }
+    }
+    AllocTraits::deallocate(Base::alloc_, old_data_, old_capacity_);
+    old_data_ = nullptr;
+    old_capacity_ = 0;
+    old_head_ = 0;
+    pending_ = 0;
+  }
+
+  void popped(size_type n) {
+    if constexpr (ShrinkPolicy::enabled) {
+      if (!ShrinkPolicy::low(size(), Base::capacity_)) {
+        low_pops_ = 0;
+        return;
+      }
+      low_pops_ += n;
+      if (low_pops_ >= ShrinkPolicy::pops) {
+        low_pops_ = 0;
+        const size_type new_capacity = CapacityPolicy::round(std::max(ShrinkPolicy::next(Base::capacity_), size()));
+        if (new_capacity < Base::capacity_) resize_storage(new_capacity);
       }
-      CircBuff<T, Allocator>::alloc_.deallocate(CircBuff<T, Allocator>::data_, CircBuff<T, Allocator>::capacity_);
-      CircBuff<T, Allocator>::data_ = new_data;
-      CircBuff<T, Allocator>::capacity_ = new_capacity;
-      CircBuff<T, Allocator>::begin_ = CircBuff<T, Allocator>::data_;
-      CircBuff<T, Allocator>::end_ = CircBuff<T, Allocator>::data_ + CircBuff<T, Allocator>::capacity_;
-      CircBuff<T, Allocator>::head_ = 0;
-      if (CircBuff<T, Allocator>::size_ != 0) CircBuff<T, Allocator>::tail_ = CircBuff<T, Allocator>::size_ - 1;
     }
-    if (!CircBuff<T, Allocator>::empty()) {
-      CircBuff<T, Allocator>::tail_ = (++CircBuff<T, Allocator>::tail_) % CircBuff<T, Allocator>::capacity_;
-      if (CircBuff<T, Allocator>::head_ == CircBuff<T, Allocator>::tail_)
-        CircBuff<T, Allocator>::head_ = (++CircBuff<T, Allocator>::head_) % CircBuff<T, Allocator>::capacity_;
+  }
+
+  void resize_storage(size_type new_capacity) {
+    settle();
+    if (new_capacity == Base::capacity_) return;
+    if (new_capacity > Base::capacity_) {
+      ++grow_events_;
+      Base::stats_.grew();
+    } else {
+      ++shrink_events_;
+      Base::stats_.shrank();
     }
-    *(CircBuff<T, Allocator>::begin_ + CircBuff<T, Allocator>::tail_) = el;
-    if (CircBuff<T, Allocator>::size_ < CircBuff<T, Allocator>::capacity_) ++CircBuff<T, Allocator>::size_;
+    Base::relocate(new_capacity, Base::size_, 0);
+    Base::tail_ = Base::size_ != 0 ? Base::size_ - 1 : 0;
   }
 
-};
\ No newline at end of file
+  size_type low_pops_ = 0;
+  size_type grow_events_ = 0;
+  size_type shrink_events_ = 0;
+  // previous block of an incremental growth, its pending_ oldest elements start at old_head_
+  T* old_data_ = nullptr;
+  size_type old_capacity_ = 0;
+  size_type old_head_ = 0;
+  size_type pending_ = 0;
+};
+
+#if __has_include(<memory_resource>)
+// Buffers that allocate from a std::pmr::memory_resource, e.g. a per-request
+// monotonic arena. Elements that take a polymorphic allocator get the same one.
+namespace pmr {
+
+template<typename T, typename CapacityPolicy = CircBuffModuloCapacity, CircBuffOnFull OnFull = CircBuffOnFull::overwrite,
+    typename Stats = CircBuffNoStats>
+using CircBuff = ::CircBuff<T, std::pmr::polymorphic_allocator<T>, CapacityPolicy, OnFull, Stats>;
+
+template<typename T, typename CapacityPolicy = CircBuffModuloCapacity, typename GrowthPolicy = CircBuffGrowth<>,
+    typename ShrinkPolicy = CircBuffNoShrink, typename Stats = CircBuffNoStats>
+using CircBuffExtended =
+    ::CircBuffExtended<T, std::pmr::polymorphic_allocator<T>, CapacityPolicy, GrowthPolicy, ShrinkPolicy, Stats>;
+
+}  // namespace pmr
+#endif
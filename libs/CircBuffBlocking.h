@@ -0,0 +1,168 @@
+#pragma once
+
+#include "CircBuff.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+// Bounded queue for pipeline stages that sleep instead of spinning when the
+// buffer is empty or full. Sleepers are counted, and a notification is sent
+// only when someone sleeps and the buffer just left the empty (or full)
+// state. A woken thread that leaves elements (or free slots) behind wakes
+// the next sleeper, so a burst never turns into one syscall per element.
+template<typename T, typename Allocator = std::allocator<T>>
+class CircBuffBlocking {
+ public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using size_type = size_t;
+
+  explicit CircBuffBlocking(size_type capacity) : buff_(capacity) {
+    if (capacity == 0) throw std::runtime_error("blocking buffer with capacity=0");
+  }
+
+  CircBuffBlocking(const CircBuffBlocking&) = delete;
+  CircBuffBlocking& operator=(const CircBuffBlocking&) = delete;
+
+  bool try_push(const T& el) {
+    return push_until(el, nullptr);
+  }
+
+  bool try_push(T&& el) {
+    return push_until(std::move(el), nullptr);
+  }
+
+  // waits while the buffer is full
+  void push_wait(const T& el) {
+    push_until(el, &kForever);
+  }
+
+  void push_wait(T&& el) {
+    push_until(std::move(el), &kForever);
+  }
+
+  // Returns false if the buffer stayed full for the whole timeout.
+  template<typename Rep, typename Period>
+  bool push_wait(const T& el, const std::chrono::duration<Rep, Period>& timeout) {
+    const auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(timeout);
+    return push_until(el, &deadline);
+  }
+
+  template<typename Rep, typename Period>
+  bool push_wait(T&& el, const std::chrono::duration<Rep, Period>& timeout) {
+    const auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(timeout);
+    return push_until(std::move(el), &deadline);
+  }
+
+  bool try_pop(T& out) {
+    return pop_until(&out, 1, nullptr) != 0;
+  }
+
+  // waits while the buffer is empty
+  void pop_wait(T& out) {
+    pop_until(&out, 1, &kForever);
+  }
+
+  // Returns false if the buffer stayed empty for the whole timeout.
+  template<typename Rep, typename Period>
+  bool pop_wait(T& out, const std::chrono::duration<Rep, Period>& timeout) {
+    const auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(timeout);
+    return pop_until(&out, 1, &deadline) != 0;
+  }
+
+  // Waits for at least one element and moves up to max_n of them to out
+  // under a single lock. Returns the number of elements popped.
+  size_type pop_wait_batch(T* out, size_type max_n) {
+    return pop_until(out, max_n, &kForever);
+  }
+
+  // Returns 0 if the buffer stayed empty for the whole timeout.
+  template<typename Rep, typename Period>
+  size_type pop_wait_batch(T* out, size_type max_n, const std::chrono::duration<Rep, Period>& timeout) {
+    const auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(timeout);
+    return pop_until(out, max_n, &deadline);
+  }
+
+  [[nodiscard]] size_type size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return buff_.size();
+  }
+
+  [[nodiscard]] bool empty() const {
+    return size() == 0;
+  }
+
+  [[nodiscard]] size_type capacity() const {
+    return buff_.capacity();
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr Clock::time_point kForever = Clock::time_point::max();
+
+  // Sleeps on cv until ready() holds. A null deadline means do not wait at
+  // all, kForever means no timeout. Returns ready().
+  template<typename Ready>
+  bool wait(std::unique_lock<std::mutex>& lock, std::condition_variable& cv, size_type& sleepers,
+            const Clock::time_point* deadline, Ready ready) {
+    if (ready() || deadline == nullptr) return ready();
+    ++sleepers;
+    if (*deadline == kForever) {
+      cv.wait(lock, ready);
+    } else {
+      cv.wait_until(lock, *deadline, ready);
+    }
+    --sleepers;
+    return ready();
+  }
+
+  template<typename U>
+  bool push_until(U&& el, const Clock::time_point* deadline) {
+    bool wake_consumer = false;
+    bool wake_producer = false;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (!wait(lock, not_full_, sleeping_producers_, deadline, [this] { return buff_.size() < buff_.capacity(); })) {
+        return false;
+      }
+      wake_consumer = buff_.empty() && sleeping_consumers_ != 0;
+      buff_.push(std::forward<U>(el));
+      wake_producer = buff_.size() < buff_.capacity() && sleeping_producers_ != 0;
+    }
+    if (wake_consumer) not_empty_.notify_one();
+    if (wake_producer) not_full_.notify_one();
+    return true;
+  }
+
+  size_type pop_until(T* out, size_type max_n, const Clock::time_point* deadline) {
+    size_type popped = 0;
+    bool wake_producer = false;
+    bool wake_consumer = false;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (!wait(lock, not_empty_, sleeping_consumers_, deadline, [this] { return !buff_.empty(); })) {
+        return 0;
+      }
+      wake_producer = buff_.size() == buff_.capacity() && sleeping_producers_ != 0;
+      popped = buff_.pop_n(out, max_n);
+      wake_consumer = !buff_.empty() && sleeping_consumers_ != 0;
+    }
+    if (wake_producer) not_full_.notify_one();
+    if (wake_consumer) not_empty_.notify_one();
+    return popped;
+  }
+
+  mutable std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  size_type sleeping_consumers_ = 0;
+  size_type sleeping_producers_ = 0;
+  CircBuff<T, Allocator, CircBuffModuloCapacity, CircBuffOnFull::reject> buff_;
+};
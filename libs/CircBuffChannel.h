@@ -0,0 +1,194 @@
+#pragma once
+
+#if __cplusplus < 202002L
+#error "CircBuffChannel.h needs C++20 coroutines"
+#endif
+
+#include "CircBuff.h"
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+// Fire-and-forget coroutine. It starts suspended, CircBuffExecutor::spawn
+// schedules it, and its frame is freed when it finishes.
+class CircBuffTask {
+ public:
+  struct promise_type {
+    CircBuffTask get_return_object() {
+      return CircBuffTask(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+
+  CircBuffTask(CircBuffTask&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+  CircBuffTask(const CircBuffTask&) = delete;
+  CircBuffTask& operator=(const CircBuffTask&) = delete;
+
+  ~CircBuffTask() {
+    if (handle_) handle_.destroy();
+  }
+
+  std::coroutine_handle<> release() {
+    return std::exchange(handle_, nullptr);
+  }
+
+ private:
+  explicit CircBuffTask(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+// Minimal single-threaded executor: resumes scheduled coroutines one after
+// another on the thread that calls run().
+class CircBuffExecutor {
+ public:
+  void spawn(CircBuffTask task) {
+    schedule(task.release());
+  }
+
+  void schedule(std::coroutine_handle<> handle) {
+    ready_.push(handle);
+  }
+
+  // runs until no coroutine is ready, coroutines still waiting on a channel stay suspended
+  void run() {
+    std::coroutine_handle<> handle;
+    while (ready_.try_pop(handle)) {
+      handle.resume();
+    }
+  }
+
+ private:
+  CircBuffExtended<std::coroutine_handle<>> ready_;
+};
+
+// Bounded channel between coroutines: co_await push(x) suspends while the
+// channel is full and co_await pop() while it is empty, instead of blocking
+// the thread. Waiters are resumed in the order they suspended, through the
+// executor rather than inline. Not thread-safe, every coroutine using a
+// channel has to run on the executor's thread.
+template<typename T, typename Allocator = std::allocator<T>, typename Executor = CircBuffExecutor>
+class CircBuffChannel {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  class PushAwaiter {
+   public:
+    PushAwaiter(CircBuffChannel& channel, T value) : channel_(channel), value_(std::move(value)) {}
+
+    bool await_ready() {
+      return channel_.try_push_now(value_);
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+      handle_ = handle;
+      channel_.push_waiters_.push(this);
+    }
+
+    void await_resume() const {}
+
+   private:
+    friend class CircBuffChannel;
+
+    CircBuffChannel& channel_;
+    T value_;
+    std::coroutine_handle<> handle_;
+  };
+
+  class PopAwaiter {
+   public:
+    explicit PopAwaiter(CircBuffChannel& channel) : channel_(channel) {}
+
+    bool await_ready() {
+      return channel_.try_pop_now(value_);
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+      handle_ = handle;
+      channel_.pop_waiters_.push(this);
+    }
+
+    T await_resume() {
+      return std::move(*value_);
+    }
+
+   private:
+    friend class CircBuffChannel;
+
+    CircBuffChannel& channel_;
+    std::optional<T> value_;
+    std::coroutine_handle<> handle_;
+  };
+
+  CircBuffChannel(size_type capacity, Executor& executor) : buff_(capacity), executor_(executor) {
+    if (capacity == 0) throw std::runtime_error("channel with capacity=0");
+  }
+
+  CircBuffChannel(const CircBuffChannel&) = delete;
+  CircBuffChannel& operator=(const CircBuffChannel&) = delete;
+
+  [[nodiscard]] PushAwaiter push(const T& el) {
+    return PushAwaiter(*this, el);
+  }
+
+  [[nodiscard]] PushAwaiter push(T&& el) {
+    return PushAwaiter(*this, std::move(el));
+  }
+
+  [[nodiscard]] PopAwaiter pop() {
+    return PopAwaiter(*this);
+  }
+
+  [[nodiscard]] size_type size() const {
+    return buff_.size();
+  }
+
+  [[nodiscard]] bool empty() const {
+    return buff_.empty();
+  }
+
+  [[nodiscard]] size_type capacity() const {
+    return buff_.capacity();
+  }
+
+ private:
+  // Pop waiters exist only while the buffer is empty, so a value goes
+  // straight to the oldest of them. Otherwise it is buffered if there is room.
+  bool try_push_now(T& el) {
+    PopAwaiter* waiter = nullptr;
+    if (pop_waiters_.try_pop(waiter)) {
+      waiter->value_.emplace(std::move(el));
+      executor_.schedule(waiter->handle_);
+      return true;
+    }
+    return buff_.try_push(std::move(el));
+  }
+
+  // Push waiters exist only while the buffer is full, so the oldest of them
+  // takes the slot freed by this pop and the order is kept.
+  bool try_pop_now(std::optional<T>& out) {
+    if (buff_.empty()) return false;
+    out.emplace(std::move(buff_[0]));
+    buff_.pop();
+    PushAwaiter* waiter = nullptr;
+    if (push_waiters_.try_pop(waiter)) {
+      buff_.push(std::move(waiter->value_));
+      executor_.schedule(waiter->handle_);
+    }
+    return true;
+  }
+
+  CircBuff<T, Allocator, CircBuffModuloCapacity, CircBuffOnFull::reject> buff_;
+  CircBuffExtended<PushAwaiter*> push_waiters_;
+  CircBuffExtended<PopAwaiter*> pop_waiters_;
+  Executor& executor_;
+};
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "CircBuff.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Ring whose storage is mapped twice back to back, so data_[i] and
+// data_[i + capacity_] are the same memory and the live contents are always
+// one contiguous range starting at data(). Capacity is rounded up to whole
+// pages. If the double mapping is unavailable the ring falls back to
+// Allocator storage of twice the capacity and writes every element to both
+// halves, keeping the same contiguous view.
+template<typename T, typename Allocator = std::allocator<T>>
+class CircBuffMirrored {
+  static_assert(std::is_trivially_copyable_v<T>, "CircBuffMirrored needs trivially copyable elements");
+
+ public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using size_type = size_t;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  explicit CircBuffMirrored(size_type capacity, bool use_mapping = true, const Allocator& alloc = Allocator())
+      : alloc_(alloc) {
+    if (capacity == 0) throw std::runtime_error("mirrored buffer with capacity=0");
+    if (!use_mapping || !map(capacity)) {
+      capacity_ = capacity;
+      data_ = alloc_.allocate(2 * capacity_);
+    }
+  }
+
+  CircBuffMirrored(const CircBuffMirrored&) = delete;
+  CircBuffMirrored& operator=(const CircBuffMirrored&) = delete;
+
+  ~CircBuffMirrored() {
+#if defined(__linux__)
+    if (mapped_) {
+      munmap(data_, 2 * capacity_ * sizeof(T));
+      return;
+    }
+#endif
+    alloc_.deallocate(data_, 2 * capacity_);
+  }
+
+  iterator begin() { return data_ + head_; }
+  iterator end() { return data_ + head_ + size_; }
+  const_iterator begin() const { return data_ + head_; }
+  const_iterator end() const { return data_ + head_ + size_; }
+  const_iterator cbegin() const { return data_ + head_; }
+  const_iterator cend() const { return data_ + head_ + size_; }
+
+  // all live elements, oldest first, as one range
+  T* data() { return data_ + head_; }
+  const T* data() const { return data_ + head_; }
+
+  CircBuffSpan<T> contents() { return CircBuffSpan<T>(data(), size_); }
+  CircBuffSpan<const T> contents() const { return CircBuffSpan<const T>(data(), size_); }
+
+  T& operator[](size_type n) { return data_[head_ + n]; }
+  const T& operator[](size_type n) const { return data_[head_ + n]; }
+
+  [[nodiscard]] bool empty() const {
+    return size_ == 0;
+  }
+
+  [[nodiscard]] size_type size() const {
+    return size_;
+  }
+
+  [[nodiscard]] size_type capacity() const {
+    return capacity_;
+  }
+
+  // true when storage is double-mapped, false on the allocator fallback
+  [[nodiscard]] bool is_mapped() const {
+    return mapped_;
+  }
+
+  // overwrites the oldest element when full, like CircBuff::push
+  void push(const T& el) {
+    push_n(&el, 1);
+  }
+
+  void push_n(const T* items, size_type n) {
+    if (n > capacity_) {
+      items += n - capacity_;
+      n = capacity_;
+    }
+    const size_type start = wrap(head_ + size_);
+    std::memcpy(data_ + start, items, n * sizeof(T));
+    if (!mapped_) mirror(start, n);
+    if (size_ + n > capacity_) {
+      head_ = wrap(head_ + size_ + n - capacity_);
+      size_ = capacity_;
+    } else {
+      size_ += n;
+    }
+  }
+
+  void pop() {
+    if (empty()) throw std::runtime_error("pop from empty buffer");
+    consume(1);
+  }
+
+  // copies up to n oldest elements to out in one memcpy and drops them
+  size_type pop_n(T* out, size_type n) {
+    n = std::min(n, size_);
+    std::memcpy(out, data(), n * sizeof(T));
+    consume(n);
+    return n;
+  }
+
+  // drops n oldest elements, e.g. after reading them through data()
+  void consume(size_type n) {
+    n = std::min(n, size_);
+    head_ = wrap(head_ + n);
+    size_ -= n;
+  }
+
+  void clear() {
+    head_ = 0;
+    size_ = 0;
+  }
+
+ private:
+  size_type wrap(size_type index) const {
+    return index >= capacity_ ? index - capacity_ : index;
+  }
+
+  // copies the n slots written at [start, start + n) into the other half
+  void mirror(size_type start, size_type n) {
+    const size_type low = std::min(n, capacity_ - std::min(start, capacity_));
+    if (low != 0) std::memcpy(data_ + start + capacity_, data_ + start, low * sizeof(T));
+    if (n > low) {
+      const size_type high = start + low;
+      std::memcpy(data_ + high - capacity_, data_ + high, (n - low) * sizeof(T));
+    }
+  }
+
+  bool map(size_type capacity) {
+#if defined(__linux__)
+    const auto page = static_cast<size_type>(sysconf(_SC_PAGESIZE));
+    const size_type unit = std::lcm(page, sizeof(T));
+    const size_type bytes = (capacity * sizeof(T) + unit - 1) / unit * unit;
+    const int fd = memfd_create("CircBuffMirrored", MFD_CLOEXEC);
+    if (fd == -1) return false;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+      close(fd);
+      return false;
+    }
+    void* area = mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (area == MAP_FAILED) {
+      close(fd);
+      return false;
+    }
+    auto* base = static_cast<unsigned char*>(area);
+    const bool ok = mmap(base, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+        mmap(base + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+    close(fd);
+    if (!ok) {
+      munmap(area, 2 * bytes);
+      return false;
+    }
+    data_ = reinterpret_cast<T*>(base);
+    capacity_ = bytes / sizeof(T);
+    mapped_ = true;
+    return true;
+#else
+    (void) capacity;
+    return false;
+#endif
+  }
+
+  size_type capacity_ = 0;
+  size_type size_ = 0;
+  size_type head_ = 0;
+  T* data_ = nullptr;
+  bool mapped_ = false;
+  Allocator alloc_;
+};
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "CircBuff.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+// Bounded lock-free queue for many producers and many consumers.
+// Every slot carries a sequence number telling whose turn it is: a slot at
+// position pos is free for the producer when sequence == pos and holds a value
+// for the consumer when sequence == pos + 1.
+// OnFull decides whether push drops an element or waits for a consumer when
+// the queue is full.
+template<typename T, typename Allocator = std::allocator<T>, typename CapacityPolicy = CircBuffModuloCapacity,
+    CircBuffOnFull OnFull = CircBuffOnFull::reject>
+class CircBuffMpmc {
+  static_assert(OnFull != CircBuffOnFull::overwrite, "producers cannot overwrite slots a consumer may be reading");
+
+  struct Cell {
+    std::atomic<size_t> sequence;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+  using CellAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Cell>;
+
+ public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+
+  explicit CircBuffMpmc(size_type capacity, const Allocator& alloc = Allocator())
+      : capacity_(CapacityPolicy::round(capacity)), alloc_(alloc) {
+    // with one cell "free for pos + 1" and "full for pos" are the same sequence
+    if (capacity_ < 2) throw std::runtime_error("mpmc buffer needs capacity >= 2");
+    cells_ = alloc_.allocate(capacity_);
+    for (size_type i = 0; i < capacity_; ++i) {
+      new(&cells_[i].sequence) std::atomic<size_t>(i);
+    }
+  }
+
+  CircBuffMpmc(const CircBuffMpmc&) = delete;
+  CircBuffMpmc& operator=(const CircBuffMpmc&) = delete;
+
+  ~CircBuffMpmc() {
+    size_type pos = dequeue_pos_.load(std::memory_order_relaxed);
+    const size_type end = enqueue_pos_.load(std::memory_order_relaxed);
+    for (; pos != end; ++pos) {
+      value(cell_at(pos))->~T();
+    }
+    alloc_.deallocate(cells_, capacity_);
+  }
+
+  bool try_push(const T& el) {
+    return try_emplace(el);
+  }
+
+  bool try_push(T&& el) {
+    return try_emplace(std::move(el));
+  }
+
+  template<typename... Args>
+  bool try_emplace(Args&& ... args) {
+    if (place(std::forward<Args>(args)...)) return true;
+    rejected_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // Drops the element or waits for a free slot, depending on OnFull.
+  void push(const T& el) {
+    emplace(el);
+  }
+
+  void push(T&& el) {
+    emplace(std::move(el));
+  }
+
+  template<typename... Args>
+  void emplace(Args&& ... args) {
+    if constexpr (OnFull == CircBuffOnFull::block) {
+      while (!place(std::forward<Args>(args)...)) {
+        std::this_thread::yield();
+      }
+    } else {
+      try_emplace(std::forward<Args>(args)...);
+    }
+  }
+
+  bool try_pop(T& out) {
+    size_type pos = dequeue_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cell_at(pos);
+      const size_type seq = cell->sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    take(*cell, out, pos);
+    return true;
+  }
+
+  // Claims up to n consecutive slots with a single CAS and fills them from items.
+  // Returns the number of elements pushed.
+  size_type try_push_n(const T* items, size_type n) {
+    size_type pos = enqueue_pos_.load(std::memory_order_relaxed);
+    size_type count;
+    do {
+      count = 0;
+      while (count < n && count < capacity_ &&
+          cell_at(pos + count).sequence.load(std::memory_order_acquire) == pos + count) {
+        ++count;
+      }
+      if (count == 0) break;
+    } while (!enqueue_pos_.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed));
+    if (count != n) rejected_.fetch_add(n - count, std::memory_order_relaxed);
+    for (size_type i = 0; i < count; ++i) {
+      Cell& cell = cell_at(pos + i);
+      new(cell.storage) T(items[i]);
+      cell.sequence.store(pos + i + 1, std::memory_order_release);
+    }
+    return count;
+  }
+
+  // Claims up to n consecutive filled slots with a single CAS and moves them to out.
+  // Returns the number of elements popped.
+  size_type try_pop_n(T* out, size_type n) {
+    size_type pos = dequeue_pos_.load(std::memory_order_relaxed);
+    size_type count;
+    do {
+      count = 0;
+      while (count < n && count < capacity_ &&
+          cell_at(pos + count).sequence.load(std::memory_order_acquire) == pos + count + 1) {
+        ++count;
+      }
+      if (count == 0) return 0;
+    } while (!dequeue_pos_.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed));
+    for (size_type i = 0; i < count; ++i) {
+      take(cell_at(pos + i), out[i], pos + i);
+    }
+    return count;
+  }
+
+  // approximate while other threads are running
+  [[nodiscard]] size_type size() const {
+    const size_type dequeued = dequeue_pos_.load(std::memory_order_acquire);
+    const size_type enqueued = enqueue_pos_.load(std::memory_order_acquire);
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+  }
+
+  [[nodiscard]] bool empty() const {
+    return size() == 0;
+  }
+
+  [[nodiscard]] size_type capacity() const {
+    return capacity_;
+  }
+
+  // pushes dropped because the queue was full
+  [[nodiscard]] size_type rejected() const {
+    return rejected_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // claims a free slot and constructs into it, args are untouched on failure
+  template<typename... Args>
+  bool place(Args&& ... args) {
+    size_type pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cell_at(pos);
+      const size_type seq = cell->sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    new(cell->storage) T(std::forward<Args>(args)...);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  Cell& cell_at(size_type pos) const {
+    return cells_[CapacityPolicy::wrap(pos, capacity_)];
+  }
+
+  static T* value(Cell& cell) {
+    return std::launder(reinterpret_cast<T*>(cell.storage));
+  }
+
+  void take(Cell& cell, T& out, size_type pos) {
+    T* el = value(cell);
+    out = std::move(*el);
+    el->~T();
+    cell.sequence.store(pos + capacity_, std::memory_order_release);
+  }
+
+  size_type capacity_ = 0;
+  Cell* cells_ = nullptr;
+  CellAllocator alloc_;
+
+  alignas(kCircBuffCacheLine) std::atomic<size_type> enqueue_pos_{0};
+  alignas(kCircBuffCacheLine) std::atomic<size_type> dequeue_pos_{0};
+  alignas(kCircBuffCacheLine) std::atomic<size_type> rejected_{0};
+};
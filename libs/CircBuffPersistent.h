@@ -0,0 +1,280 @@
+#pragma once
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "CircBuffPersistent.h needs POSIX mmap"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Ring of trivially copyable elements kept in an mmaped file, so its
+// contents survive restarts and crashes. Reopening the file maps it back
+// without any deserialization.
+//
+// File layout: two 64-byte headers at offsets 0 and 64, then capacity
+// slots starting at offset 128 (rounded up to the slot alignment). A slot
+// is the element plus the logical index it was written for.
+//
+// Commit protocol: a write first fills the slots, clearing each stamp before
+// the value changes and setting it to the element's index after, then
+// publishes the new head and tail by writing the older header with the next
+// generation and a checksum. Recovery takes the valid header
+// with the highest generation, so a commit torn by a crash falls back to
+// the previous one, and keeps only the slots between head and tail whose
+// stamps match. Slots that never reached the disk are dropped that way.
+//
+// sync_every sets how often a commit msyncs the mapping: 0 leaves it to
+// the kernel (survives a crash of the process, not of the machine), 1
+// syncs every commit, N syncs every N-th commit. sync() forces one.
+template<typename T>
+class CircBuffPersistent {
+  static_assert(std::is_trivially_copyable_v<T>, "CircBuffPersistent needs trivially copyable elements");
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  // Opens path, creating it for capacity elements if it does not exist. An
+  // existing file has to be laid out for the same T and capacity.
+  CircBuffPersistent(const std::string& path, size_type capacity, size_type sync_every = 0)
+      : capacity_(capacity), sync_every_(sync_every) {
+    if (capacity == 0) throw std::runtime_error("persistent buffer with capacity=0");
+    open_file(path);
+  }
+
+  CircBuffPersistent(const CircBuffPersistent&) = delete;
+  CircBuffPersistent& operator=(const CircBuffPersistent&) = delete;
+
+  ~CircBuffPersistent() {
+    if (sync_every_ != 0 && unsynced_ != 0) sync();
+    munmap(map_, bytes_);
+  }
+
+  // overwrites the oldest element when full, like CircBuff::push
+  void push(const T& el) {
+    write(tail_, el);
+    commit(std::max(head_, tail_ + 1 - std::min<uint64_t>(tail_ + 1, capacity_)), tail_ + 1);
+  }
+
+  // writes the items and commits them at once, only the last capacity ones are kept
+  void push_n(const T* items, size_type n) {
+    if (n > capacity_) {
+      items += n - capacity_;
+      n = capacity_;
+    }
+    for (size_type i = 0; i < n; ++i) {
+      write(tail_ + i, items[i]);
+    }
+    const uint64_t tail = tail_ + n;
+    commit(std::max(head_, tail - std::min<uint64_t>(tail, capacity_)), tail);
+  }
+
+  void pop() {
+    if (empty()) throw std::runtime_error("pop from empty buffer");
+    commit(head_ + 1, tail_);
+  }
+
+  // copies up to n oldest elements to out and drops them with one commit
+  size_type pop_n(T* out, size_type n) {
+    n = std::min(n, size());
+    for (size_type i = 0; i < n; ++i) {
+      out[i] = (*this)[i];
+    }
+    commit(head_ + n, tail_);
+    return n;
+  }
+
+  void clear() {
+    commit(tail_, tail_);
+  }
+
+  const T& operator[](size_type n) const {
+    return slot(head_ + n).value;
+  }
+
+  [[nodiscard]] bool empty() const {
+    return head_ == tail_;
+  }
+
+  [[nodiscard]] size_type size() const {
+    return static_cast<size_type>(tail_ - head_);
+  }
+
+  [[nodiscard]] size_type capacity() const {
+    return capacity_;
+  }
+
+  // number of commits made to the file since it was created
+  [[nodiscard]] uint64_t generation() const {
+    return generation_;
+  }
+
+  // flushes the mapping to the file
+  void sync() {
+    if (msync(map_, bytes_, MS_SYNC) != 0) fail("msync");
+    unsynced_ = 0;
+  }
+
+ private:
+  static constexpr uint64_t kMagic = 0x4642427563726943;  // file signature
+  static constexpr size_t kHeaderBytes = 64;
+
+  struct Header {
+    uint64_t magic;
+    uint64_t element_size;
+    uint64_t capacity;
+    uint64_t generation;
+    uint64_t head;  // logical index of the oldest element
+    uint64_t tail;  // logical index past the newest element
+    uint64_t checksum;
+  };
+  static_assert(sizeof(Header) <= kHeaderBytes);
+
+  struct Slot {
+    uint64_t stamp;  // logical index of the element, ~0 if never written
+    T value;
+  };
+
+  static constexpr size_t kSlotsOffset = (2 * kHeaderBytes + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+
+  static uint64_t checksum(const Header& header) {
+    const uint64_t words[] = {header.magic, header.element_size, header.capacity, header.generation, header.head,
+                              header.tail};
+    uint64_t hash = 0xcbf29ce484222325;
+    for (uint64_t word : words) {
+      hash = (hash ^ word) * 0x100000001b3;
+    }
+    return hash;
+  }
+
+  bool valid(const Header& header) const {
+    return header.magic == kMagic && header.element_size == sizeof(T) && header.capacity == capacity_ &&
+        header.checksum == checksum(header) && header.head <= header.tail && header.tail - header.head <= capacity_;
+  }
+
+  Header& header(uint64_t generation) {
+    return *reinterpret_cast<Header*>(map_ + (generation & 1) * kHeaderBytes);
+  }
+
+  Slot& slot(uint64_t index) {
+    return reinterpret_cast<Slot*>(map_ + kSlotsOffset)[index % capacity_];
+  }
+
+  const Slot& slot(uint64_t index) const {
+    return reinterpret_cast<const Slot*>(map_ + kSlotsOffset)[index % capacity_];
+  }
+
+  // The slot may still hold a committed element whose stamp matches, so the
+  // stamp is cleared before the value changes. A crash in between leaves a
+  // slot that recovery drops instead of the old element with new bytes.
+  void write(uint64_t index, const T& el) {
+    Slot& target = slot(index);
+    target.stamp = ~uint64_t(0);
+    std::atomic_signal_fence(std::memory_order_release);
+    target.value = el;
+    std::atomic_signal_fence(std::memory_order_release);
+    target.stamp = index;
+  }
+
+  // publishes head and tail under the next generation, in the header not holding the current one
+  void commit(uint64_t head, uint64_t tail) {
+    std::atomic_signal_fence(std::memory_order_release);
+    Header& next = header(generation_ + 1);
+    next.generation = generation_ + 1;
+    next.head = head;
+    next.tail = tail;
+    next.magic = kMagic;
+    next.element_size = sizeof(T);
+    next.capacity = capacity_;
+    next.checksum = checksum(next);
+    generation_ = next.generation;
+    head_ = head;
+    tail_ = tail;
+    if (sync_every_ != 0 && ++unsynced_ >= sync_every_) sync();
+  }
+
+  void open_file(const std::string& path) {
+    bytes_ = kSlotsOffset + capacity_ * sizeof(Slot);
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1) fail("open " + path);
+    struct stat st {};
+    if (fstat(fd, &st) != 0) {
+      const int error = errno;
+      close(fd);
+      fail("fstat " + path, error);
+    }
+    const bool created = st.st_size == 0;
+    if (created && ftruncate(fd, static_cast<off_t>(bytes_)) != 0) {
+      const int error = errno;
+      close(fd);
+      fail("ftruncate " + path, error);
+    }
+    if (!created && static_cast<size_t>(st.st_size) != bytes_) {
+      close(fd);
+      throw std::runtime_error(path + " was created for another element type or capacity");
+    }
+    void* area = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const int error = errno;
+    close(fd);
+    if (area == MAP_FAILED) fail("mmap " + path, error);
+    map_ = static_cast<unsigned char*>(area);
+    if (created) {
+      for (size_type i = 0; i < capacity_; ++i) {
+        slot(i).stamp = ~uint64_t(0);
+      }
+      generation_ = ~uint64_t(0);
+      commit(0, 0);
+      return;
+    }
+    recover(path);
+  }
+
+  void recover(const std::string& path) {
+    const Header& first = header(0);
+    const Header& second = header(1);
+    const bool first_valid = valid(first);
+    const bool second_valid = valid(second);
+    if (!first_valid && !second_valid) {
+      munmap(map_, bytes_);
+      throw std::runtime_error(path + " has no valid header");
+    }
+    const Header& current = !second_valid || (first_valid && first.generation > second.generation) ? first : second;
+    generation_ = current.generation;
+    head_ = current.head;
+    tail_ = current.tail;
+    while (head_ != tail_ && slot(head_).stamp != head_) {
+      ++head_;
+    }
+    uint64_t end = head_;
+    while (end != tail_ && slot(end).stamp == end) {
+      ++end;
+    }
+    if (head_ != current.head || end != tail_) commit(head_, end);
+  }
+
+  // error defaults to errno, callers that clean up first pass the saved one
+  [[noreturn]] static void fail(const std::string& what, int error = errno) {
+    throw std::runtime_error(what + ": " + std::strerror(error));
+  }
+
+  size_type capacity_;
+  size_type sync_every_;
+  size_type unsynced_ = 0;
+  uint64_t generation_ = 0;
+  uint64_t head_ = 0;
+  uint64_t tail_ = 0;
+  unsigned char* map_ = nullptr;
+  size_t bytes_ = 0;
+};
@@ -0,0 +1,192 @@
+#pragma once
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "CircBuffShm.h needs POSIX shared memory"
+#endif
+
+#include "CircBuff.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Lock-free ring for one producer process and one consumer process. The
+// control block and the slots live in a POSIX shared memory segment. The
+// shared state holds only indices, never pointers, and slots are found at a
+// fixed offset from wherever the segment is mapped, so each process may map
+// it at a different address.
+// One slot is kept free so that head == tail always means "empty".
+//
+// The creating side sizes and initializes the segment and removes its name
+// when destroyed, the other side attaches to it by name.
+template<typename T>
+class CircBuffShm {
+  static_assert(std::is_trivially_copyable_v<T>, "CircBuffShm needs trivially copyable elements");
+  static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared atomics have to be lock-free");
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  // Creates the segment name (e.g. "/feed") for capacity elements, replacing
+  // a stale segment with the same name.
+  CircBuffShm(const std::string& name, size_type capacity) : name_(name), owner_(true) {
+    if (capacity == 0) throw std::runtime_error("shared memory buffer with capacity=0");
+    const uint64_t slots = capacity + 1;
+    bytes_ = kSlotsOffset + slots * sizeof(T);
+    shm_unlink(name.c_str());
+    const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd == -1) fail("shm_open " + name);
+    if (ftruncate(fd, static_cast<off_t>(bytes_)) != 0) {
+      const int error = errno;
+      close(fd);
+      shm_unlink(name.c_str());
+      fail("ftruncate " + name, error);
+    }
+    map(fd);
+    control_ = new(base_) Control();
+    control_->slots = slots;
+    control_->element_size = sizeof(T);
+    control_->magic.store(kMagic, std::memory_order_release);
+    slots_ = slots;
+  }
+
+  // Attaches to the segment made by the other side.
+  explicit CircBuffShm(const std::string& name) : name_(name), owner_(false) {
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd == -1) fail("shm_open " + name);
+    struct stat st {};
+    if (fstat(fd, &st) != 0) {
+      const int error = errno;
+      close(fd);
+      fail("fstat " + name, error);
+    }
+    bytes_ = static_cast<size_t>(st.st_size);
+    if (bytes_ < kSlotsOffset) {
+      close(fd);
+      throw std::runtime_error(name + " is not initialized");
+    }
+    map(fd);
+    control_ = reinterpret_cast<Control*>(base_);
+    if (control_->magic.load(std::memory_order_acquire) != kMagic || control_->element_size != sizeof(T) ||
+        kSlotsOffset + control_->slots * sizeof(T) != bytes_) {
+      munmap(base_, bytes_);
+      throw std::runtime_error(name + " is not a ring of this element type");
+    }
+    slots_ = control_->slots;
+    cached_head_ = control_->head.load(std::memory_order_acquire);
+    cached_tail_ = control_->tail.load(std::memory_order_acquire);
+  }
+
+  CircBuffShm(const CircBuffShm&) = delete;
+  CircBuffShm& operator=(const CircBuffShm&) = delete;
+
+  ~CircBuffShm() {
+    munmap(base_, bytes_);
+    if (owner_) shm_unlink(name_.c_str());
+  }
+
+  // producer side
+  bool try_push(const T& el) {
+    const uint64_t tail = control_->tail.load(std::memory_order_relaxed);
+    const uint64_t next_tail = next(tail);
+    if (next_tail == cached_head_) {
+      cached_head_ = control_->head.load(std::memory_order_acquire);
+      if (next_tail == cached_head_) return false;
+    }
+    std::memcpy(slot(tail), &el, sizeof(T));
+    control_->tail.store(next_tail, std::memory_order_release);
+    return true;
+  }
+
+  // consumer side
+  bool try_pop(T& out) {
+    const uint64_t head = control_->head.load(std::memory_order_relaxed);
+    if (head == cached_tail_) {
+      cached_tail_ = control_->tail.load(std::memory_order_acquire);
+      if (head == cached_tail_) return false;
+    }
+    std::memcpy(&out, slot(head), sizeof(T));
+    control_->head.store(next(head), std::memory_order_release);
+    return true;
+  }
+
+  // size() and empty() are exact only while the other side is idle
+  [[nodiscard]] bool empty() const {
+    return control_->head.load(std::memory_order_acquire) == control_->tail.load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] size_type size() const {
+    const uint64_t head = control_->head.load(std::memory_order_acquire);
+    const uint64_t tail = control_->tail.load(std::memory_order_acquire);
+    return static_cast<size_type>(tail >= head ? tail - head : slots_ - head + tail);
+  }
+
+  [[nodiscard]] size_type capacity() const {
+    return static_cast<size_type>(slots_ - 1);
+  }
+
+ private:
+  static constexpr uint64_t kMagic = 0x6d68536675427243;
+
+  // shared state at the start of the segment
+  struct Control {
+    std::atomic<uint64_t> magic{0};  // set last by the creator
+    uint64_t element_size = 0;
+    uint64_t slots = 0;
+
+    // consumer cache line
+    alignas(kCircBuffCacheLine) std::atomic<uint64_t> head{0};
+
+    // producer cache line
+    alignas(kCircBuffCacheLine) std::atomic<uint64_t> tail{0};
+  };
+
+  static constexpr size_t kSlotAlign = alignof(T) > kCircBuffCacheLine ? alignof(T) : kCircBuffCacheLine;
+  static constexpr size_t kSlotsOffset = (sizeof(Control) + kSlotAlign - 1) / kSlotAlign * kSlotAlign;
+
+  void map(int fd) {
+    void* area = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const int error = errno;
+    close(fd);
+    if (area == MAP_FAILED) {
+      if (owner_) shm_unlink(name_.c_str());
+      fail("mmap " + name_, error);
+    }
+    base_ = static_cast<unsigned char*>(area);
+  }
+
+  unsigned char* slot(uint64_t index) const {
+    return base_ + kSlotsOffset + index * sizeof(T);
+  }
+
+  uint64_t next(uint64_t index) const {
+    return index + 1 == slots_ ? 0 : index + 1;
+  }
+
+  // error defaults to errno, callers that clean up first pass the saved one
+  [[noreturn]] static void fail(const std::string& what, int error = errno) {
+    throw std::runtime_error(what + ": " + std::strerror(error));
+  }
+
+  std::string name_;
+  bool owner_;
+  size_t bytes_ = 0;
+  unsigned char* base_ = nullptr;
+  Control* control_ = nullptr;
+  // copy of control_->slots, kept next to the caches of the other side's index
+  uint64_t slots_ = 0;
+  uint64_t cached_head_ = 0;
+  uint64_t cached_tail_ = 0;
+};
@@ -0,0 +1,463 @@
+#pragma once
+
+#include "CircBuff.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CIRCBUFF_SIMD_X86 1
+#include <immintrin.h>
+#define CIRCBUFF_TARGET_AVX2 __attribute__((target("avx2")))
+#define CIRCBUFF_TARGET_SSE42 __attribute__((target("sse4.2")))
+#else
+#define CIRCBUFF_SIMD_X86 0
+#endif
+
+// Instruction sets the kernels below can run with, in increasing order.
+enum class CircBuffIsa {
+  scalar,
+  sse42,
+  avx2,
+};
+
+// Reduction and search kernels for int32_t, int64_t, float and double.
+// They run over the at most two contiguous segments of a CircBuff, so no
+// per-element wrap check gets in the way of vectorization, and pick AVX2,
+// SSE4.2 or plain loops at runtime from what the CPU supports.
+// Floating point sums are accumulated in double lanes, so they may differ
+// from a sequential sum in the last bits. NaNs are not handled specially.
+class CircBuffSimd {
+ public:
+  template<typename T>
+  using sum_type = std::conditional_t<std::is_floating_point_v<T>, double, int64_t>;
+
+  static CircBuffIsa detected_isa() {
+#if CIRCBUFF_SIMD_X86
+    static const CircBuffIsa isa = __builtin_cpu_supports("avx2") ? CircBuffIsa::avx2
+        : __builtin_cpu_supports("sse4.2") ? CircBuffIsa::sse42 : CircBuffIsa::scalar;
+    return isa;
+#else
+    return CircBuffIsa::scalar;
+#endif
+  }
+
+  // Kernels over one contiguous span. isa is capped at detected_isa().
+
+  template<typename T>
+  static sum_type<T> sum(CircBuffSpan<const T> span, CircBuffIsa isa = detected_isa()) {
+    check_type<T>();
+    switch (std::min(isa, detected_isa())) {
+#if CIRCBUFF_SIMD_X86
+      case CircBuffIsa::avx2:
+        return sum_avx2(span.data(), span.size());
+      case CircBuffIsa::sse42:
+        return sum_sse42(span.data(), span.size());
+#endif
+      default:
+        return sum_scalar(span.data(), span.size());
+    }
+  }
+
+  template<typename T>
+  static T min(CircBuffSpan<const T> span, CircBuffIsa isa = detected_isa()) {
+    return extreme<false>(span, isa);
+  }
+
+  template<typename T>
+  static T max(CircBuffSpan<const T> span, CircBuffIsa isa = detected_isa()) {
+    return extreme<true>(span, isa);
+  }
+
+  template<typename T>
+  static size_t count(CircBuffSpan<const T> span, T value, CircBuffIsa isa = detected_isa()) {
+    check_type<T>();
+    switch (std::min(isa, detected_isa())) {
+#if CIRCBUFF_SIMD_X86
+      case CircBuffIsa::avx2:
+        return count_avx2(span.data(), span.size(), value);
+      case CircBuffIsa::sse42:
+        return count_sse42(span.data(), span.size(), value);
+#endif
+      default:
+        return static_cast<size_t>(std::count(span.begin(), span.end(), value));
+    }
+  }
+
+  // index of the first element equal to value, span.size() if there is none
+  template<typename T>
+  static size_t find(CircBuffSpan<const T> span, T value, CircBuffIsa isa = detected_isa()) {
+    check_type<T>();
+    switch (std::min(isa, detected_isa())) {
+#if CIRCBUFF_SIMD_X86
+      case CircBuffIsa::avx2:
+        return find_avx2(span.data(), span.size(), value);
+      case CircBuffIsa::sse42:
+        return find_sse42(span.data(), span.size(), value);
+#endif
+      default:
+        return static_cast<size_t>(std::find(span.begin(), span.end(), value) - span.begin());
+    }
+  }
+
+  // The same kernels over the whole contents of a buffer, oldest first.
+
+  template<typename T, typename Allocator, typename CapacityPolicy, CircBuffOnFull OnFull, typename Stats>
+  static sum_type<T> sum(const CircBuff<T, Allocator, CapacityPolicy, OnFull, Stats>& buff,
+                         CircBuffIsa isa = detected_isa()) {
+    return sum_of(buff, isa);
+  }
+
+  template<typename T, typename Allocator, typename CapacityPolicy, CircBuffOnFull OnFull, typename Stats>
+  static T min(const CircBuff<T, Allocator, CapacityPolicy, OnFull, Stats>& buff, CircBuffIsa isa = detected_isa()) {
+    return min_of(buff, isa);
+  }
+
+  template<typename T, typename Allocator, typename CapacityPolicy, CircBuffOnFull OnFull, typename Stats>
+  static T max(const CircBuff<T, Allocator, CapacityPolicy, OnFull, Stats>& buff, CircBuffIsa isa = detected_isa()) {
+    return max_of(buff, isa);
+  }
+
+  template<typename T, typename Allocator, typename CapacityPolicy, CircBuffOnFull OnFull, typename Stats>
+  static size_t count(const CircBuff<T, Allocator, CapacityPolicy, OnFull, Stats>& buff, T value,
+                      CircBuffIsa isa = detected_isa()) {
+    return count_of(buff, value, isa);
+  }
+
+  // logical index of the first element equal to value, buff.size() if there is none
+  template<typename T, typename Allocator, typename CapacityPolicy, CircBuffOnFull OnFull, typename Stats>
+  static size_t find(const CircBuff<T, Allocator, CapacityPolicy, OnFull, Stats>& buff, T value,
+                     CircBuffIsa isa = detected_isa()) {
+    return find_of(buff, value, isa);
+  }
+
+  // CircBuffExtended goes through its own segment accessors, which finish a
+  // pending incremental growth first. Its CircBuff base alone would miss the
+  // elements still in the previous block.
+
+  template<typename T, typename Allocator, typename CapacityPolicy, typename Growth, typename Shrink, typename Stats>
+  static sum_type<T> sum(const CircBuffExtended<T, Allocator, CapacityPolicy, Growth, Shrink, Stats>& buff,
+                         CircBuffIsa isa = detected_isa()) {
+    return sum_of(buff, isa);
+  }
+
+  template<typename T, typename Allocator, typename CapacityPolicy, typename Growth, typename Shrink, typename Stats>
+  static T min(const CircBuffExtended<T, Allocator, CapacityPolicy, Growth, Shrink, Stats>& buff,
+               CircBuffIsa isa = detected_isa()) {
+    return min_of(buff, isa);
+  }
+
+  template<typename T, typename Allocator, typename CapacityPolicy, typename Growth, typename Shrink, typename Stats>
+  static T max(const CircBuffExtended<T, Allocator, CapacityPolicy, Growth, Shrink, Stats>& buff,
+               CircBuffIsa isa = detected_isa()) {
+    return max_of(buff, isa);
+  }
+
+  template<typename T, typename Allocator, typename CapacityPolicy, typename Growth, typename Shrink, typename Stats>
+  static size_t count(const CircBuffExtended<T, Allocator, CapacityPolicy, Growth, Shrink, Stats>& buff, T value,
+                      CircBuffIsa isa = detected_isa()) {
+    return count_of(buff, value, isa);
+  }
+
+  template<typename T, typename Allocator, typename CapacityPolicy, typename Growth, typename Shrink, typename Stats>
+  static size_t find(const CircBuffExtended<T, Allocator, CapacityPolicy, Growth, Shrink, Stats>& buff, T value,
+                     CircBuffIsa isa = detected_isa()) {
+    return find_of(buff, value, isa);
+  }
+
+ private:
+  template<typename Buff>
+  static auto sum_of(const Buff& buff, CircBuffIsa isa) {
+    return sum(buff.array_one(), isa) + sum(buff.array_two(), isa);
+  }
+
+  template<typename Buff>
+  static auto min_of(const Buff& buff, CircBuffIsa isa) {
+    if (buff.array_two().empty()) return min(buff.array_one(), isa);
+    return std::min(min(buff.array_one(), isa), min(buff.array_two(), isa));
+  }
+
+  template<typename Buff>
+  static auto max_of(const Buff& buff, CircBuffIsa isa) {
+    if (buff.array_two().empty()) return max(buff.array_one(), isa);
+    return std::max(max(buff.array_one(), isa), max(buff.array_two(), isa));
+  }
+
+  template<typename Buff, typename T>
+  static size_t count_of(const Buff& buff, T value, CircBuffIsa isa) {
+    return count(buff.array_one(), value, isa) + count(buff.array_two(), value, isa);
+  }
+
+  template<typename Buff, typename T>
+  static size_t find_of(const Buff& buff, T value, CircBuffIsa isa) {
+    const auto one = buff.array_one();
+    const size_t pos = find(one, value, isa);
+    return pos != one.size() ? pos : one.size() + find(buff.array_two(), value, isa);
+  }
+
+  template<typename T>
+  static constexpr void check_type() {
+    static_assert(std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> || std::is_same_v<T, float>
+                      || std::is_same_v<T, double>, "CircBuffSimd supports int32_t, int64_t, float and double");
+  }
+
+  template<bool Max, typename T>
+  static T extreme(CircBuffSpan<const T> span, CircBuffIsa isa) {
+    check_type<T>();
+    if (span.empty()) throw std::runtime_error("min/max of empty range");
+    switch (std::min(isa, detected_isa())) {
+#if CIRCBUFF_SIMD_X86
+      case CircBuffIsa::avx2:
+        return extreme_avx2<Max>(span.data(), span.size());
+      case CircBuffIsa::sse42:
+        return extreme_sse42<Max>(span.data(), span.size());
+#endif
+      default:
+        return extreme_tail<Max>(span.data(), 1, span.size(), span[0]);
+    }
+  }
+
+  template<typename T>
+  static sum_type<T> sum_scalar(const T* data, size_t n) {
+    sum_type<T> result = 0;
+    for (size_t i = 0; i < n; ++i) {
+      result += data[i];
+    }
+    return result;
+  }
+
+  // folds data[from, n) into result
+  template<bool Max, typename T>
+  static T extreme_tail(const T* data, size_t from, size_t n, T result) {
+    for (size_t i = from; i < n; ++i) {
+      result = Max ? std::max(result, data[i]) : std::min(result, data[i]);
+    }
+    return result;
+  }
+
+  template<bool Max, typename T, size_t Lanes>
+  static T extreme_lanes(const T (&lanes)[Lanes]) {
+    return extreme_tail<Max>(lanes, 1, Lanes, lanes[0]);
+  }
+
+#if CIRCBUFF_SIMD_X86
+  // AVX2, 256-bit lanes
+
+  template<typename T>
+  CIRCBUFF_TARGET_AVX2 static sum_type<T> sum_avx2(const T* data, size_t n) {
+    size_t i = 0;
+    sum_type<T> result = 0;
+    if constexpr (std::is_integral_v<T>) {
+      __m256i acc = _mm256_setzero_si256();
+      for (; i + 4 <= n; i += 4) {
+        if constexpr (sizeof(T) == 4) {
+          acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))));
+        } else {
+          acc = _mm256_add_epi64(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+        }
+      }
+      alignas(32) int64_t lanes[4];
+      _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+      result = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    } else {
+      __m256d acc = _mm256_setzero_pd();
+      for (; i + 4 <= n; i += 4) {
+        if constexpr (sizeof(T) == 4) {
+          acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm_loadu_ps(data + i)));
+        } else {
+          acc = _mm256_add_pd(acc, _mm256_loadu_pd(data + i));
+        }
+      }
+      alignas(32) double lanes[4];
+      _mm256_store_pd(lanes, acc);
+      result = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    return result + sum_scalar(data + i, n - i);
+  }
+
+  template<bool Max, typename T>
+  CIRCBUFF_TARGET_AVX2 static T extreme_avx2(const T* data, size_t n) {
+    constexpr size_t kLanes = 32 / sizeof(T);
+    if (n < kLanes) return extreme_tail<Max>(data, 1, n, data[0]);
+    alignas(32) T lanes[kLanes];
+    size_t i = kLanes;
+    if constexpr (std::is_integral_v<T>) {
+      __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+      for (; i + kLanes <= n; i += kLanes) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        if constexpr (sizeof(T) == 4) {
+          acc = Max ? _mm256_max_epi32(acc, v) : _mm256_min_epi32(acc, v);
+        } else {
+          const __m256i greater = _mm256_cmpgt_epi64(acc, v);
+          acc = Max ? _mm256_blendv_epi8(v, acc, greater) : _mm256_blendv_epi8(acc, v, greater);
+        }
+      }
+      _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    } else if constexpr (sizeof(T) == 4) {
+      __m256 acc = _mm256_loadu_ps(data);
+      for (; i + kLanes <= n; i += kLanes) {
+        const __m256 v = _mm256_loadu_ps(data + i);
+        acc = Max ? _mm256_max_ps(acc, v) : _mm256_min_ps(acc, v);
+      }
+      _mm256_store_ps(lanes, acc);
+    } else {
+      __m256d acc = _mm256_loadu_pd(data);
+      for (; i + kLanes <= n; i += kLanes) {
+        const __m256d v = _mm256_loadu_pd(data + i);
+        acc = Max ? _mm256_max_pd(acc, v) : _mm256_min_pd(acc, v);
+      }
+      _mm256_store_pd(lanes, acc);
+    }
+    return extreme_tail<Max>(data, i, n, extreme_lanes<Max>(lanes));
+  }
+
+  // bit k is set when data[k] == value
+  template<typename T>
+  CIRCBUFF_TARGET_AVX2 static int equal_mask_avx2(const T* data, T value) {
+    if constexpr (std::is_same_v<T, int32_t>) {
+      const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+      return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, _mm256_set1_epi32(value))));
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+      const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+      return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, _mm256_set1_epi64x(value))));
+    } else if constexpr (std::is_same_v<T, float>) {
+      return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(data), _mm256_set1_ps(value), _CMP_EQ_OQ));
+    } else {
+      return _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(data), _mm256_set1_pd(value), _CMP_EQ_OQ));
+    }
+  }
+
+  template<typename T>
+  CIRCBUFF_TARGET_AVX2 static size_t count_avx2(const T* data, size_t n, T value) {
+    constexpr size_t kLanes = 32 / sizeof(T);
+    size_t i = 0;
+    size_t result = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+      result += static_cast<size_t>(__builtin_popcount(equal_mask_avx2(data + i, value)));
+    }
+    return result + static_cast<size_t>(std::count(data + i, data + n, value));
+  }
+
+  template<typename T>
+  CIRCBUFF_TARGET_AVX2 static size_t find_avx2(const T* data, size_t n, T value) {
+    constexpr size_t kLanes = 32 / sizeof(T);
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+      const int mask = equal_mask_avx2(data + i, value);
+      if (mask != 0) return i + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    return static_cast<size_t>(std::find(data + i, data + n, value) - data);
+  }
+
+  // SSE4.2, 128-bit lanes
+
+  template<typename T>
+  CIRCBUFF_TARGET_SSE42 static sum_type<T> sum_sse42(const T* data, size_t n) {
+    size_t i = 0;
+    sum_type<T> result = 0;
+    if constexpr (std::is_integral_v<T>) {
+      __m128i acc = _mm_setzero_si128();
+      for (; i + 2 <= n; i += 2) {
+        if constexpr (sizeof(T) == 4) {
+          acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(data + i))));
+        } else {
+          acc = _mm_add_epi64(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+        }
+      }
+      alignas(16) int64_t lanes[2];
+      _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+      result = lanes[0] + lanes[1];
+    } else {
+      __m128d acc = _mm_setzero_pd();
+      for (; i + 2 <= n; i += 2) {
+        if constexpr (sizeof(T) == 4) {
+          const __m128i pair = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data + i));
+          acc = _mm_add_pd(acc, _mm_cvtps_pd(_mm_castsi128_ps(pair)));
+        } else {
+          acc = _mm_add_pd(acc, _mm_loadu_pd(data + i));
+        }
+      }
+      alignas(16) double lanes[2];
+      _mm_store_pd(lanes, acc);
+      result = lanes[0] + lanes[1];
+    }
+    return result + sum_scalar(data + i, n - i);
+  }
+
+  template<bool Max, typename T>
+  CIRCBUFF_TARGET_SSE42 static T extreme_sse42(const T* data, size_t n) {
+    constexpr size_t kLanes = 16 / sizeof(T);
+    if (n < kLanes) return extreme_tail<Max>(data, 1, n, data[0]);
+    alignas(16) T lanes[kLanes];
+    size_t i = kLanes;
+    if constexpr (std::is_integral_v<T>) {
+      __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+      for (; i + kLanes <= n; i += kLanes) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        if constexpr (sizeof(T) == 4) {
+          acc = Max ? _mm_max_epi32(acc, v) : _mm_min_epi32(acc, v);
+        } else {
+          const __m128i greater = _mm_cmpgt_epi64(acc, v);
+          acc = Max ? _mm_blendv_epi8(v, acc, greater) : _mm_blendv_epi8(acc, v, greater);
+        }
+      }
+      _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    } else if constexpr (sizeof(T) == 4) {
+      __m128 acc = _mm_loadu_ps(data);
+      for (; i + kLanes <= n; i += kLanes) {
+        const __m128 v = _mm_loadu_ps(data + i);
+        acc = Max ? _mm_max_ps(acc, v) : _mm_min_ps(acc, v);
+      }
+      _mm_store_ps(lanes, acc);
+    } else {
+      __m128d acc = _mm_loadu_pd(data);
+      for (; i + kLanes <= n; i += kLanes) {
+        const __m128d v = _mm_loadu_pd(data + i);
+        acc = Max ? _mm_max_pd(acc, v) : _mm_min_pd(acc, v);
+      }
+      _mm_store_pd(lanes, acc);
+    }
+    return extreme_tail<Max>(data, i, n, extreme_lanes<Max>(lanes));
+  }
+
+  template<typename T>
+  CIRCBUFF_TARGET_SSE42 static int equal_mask_sse42(const T* data, T value) {
+    if constexpr (std::is_same_v<T, int32_t>) {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+      return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, _mm_set1_epi32(value))));
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+      return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(v, _mm_set1_epi64x(value))));
+    } else if constexpr (std::is_same_v<T, float>) {
+      return _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(data), _mm_set1_ps(value)));
+    } else {
+      return _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(data), _mm_set1_pd(value)));
+    }
+  }
+
+  template<typename T>
+  CIRCBUFF_TARGET_SSE42 static size_t count_sse42(const T* data, size_t n, T value) {
+    constexpr size_t kLanes = 16 / sizeof(T);
+    size_t i = 0;
+    size_t result = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+      result += static_cast<size_t>(__builtin_popcount(equal_mask_sse42(data + i, value)));
+    }
+    return result + static_cast<size_t>(std::count(data + i, data + n, value));
+  }
+
+  template<typename T>
+  CIRCBUFF_TARGET_SSE42 static size_t find_sse42(const T* data, size_t n, T value) {
+    constexpr size_t kLanes = 16 / sizeof(T);
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+      const int mask = equal_mask_sse42(data + i, value);
+      if (mask != 0) return i + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    return static_cast<size_t>(std::find(data + i, data + n, value) - data);
+  }
+#endif
+};
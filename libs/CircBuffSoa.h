@@ -0,0 +1,198 @@
+#pragma once
+
+#include "CircBuff.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Ring of rows stored column by column: every column is its own contiguous
+// array, all of them share one head and size. Rows are pushed and popped
+// whole, while a scan over one column touches only that column's memory and
+// sees it as at most two spans, like CircBuff::array_one()/array_two().
+// The columns share one block taken from Allocator, rebound to cache-line
+// sized chunks so every column can start on its own line.
+template<typename Allocator, typename... Columns>
+class BasicCircBuffSoa {
+  static_assert(sizeof...(Columns) > 0, "CircBuffSoa needs at least one column");
+  static_assert((std::is_trivially_copyable_v<Columns> && ...), "CircBuffSoa needs trivially copyable columns");
+
+ public:
+  using size_type = size_t;
+  using allocator_type = Allocator;
+  using row_type = std::tuple<Columns...>;
+  template<size_t I>
+  using column_type = std::tuple_element_t<I, row_type>;
+
+  explicit BasicCircBuffSoa(size_type capacity, const Allocator& alloc = Allocator())
+      : capacity_(capacity), alloc_(alloc) {
+    if (capacity == 0) throw std::runtime_error("soa buffer with capacity=0");
+    block_ = reinterpret_cast<unsigned char*>(LineTraits::allocate(alloc_, lines()));
+    place_columns(std::index_sequence_for<Columns...>());
+  }
+
+  BasicCircBuffSoa(const BasicCircBuffSoa&) = delete;
+  BasicCircBuffSoa& operator=(const BasicCircBuffSoa&) = delete;
+
+  ~BasicCircBuffSoa() {
+    LineTraits::deallocate(alloc_, reinterpret_cast<Line*>(block_), lines());
+  }
+
+  allocator_type get_allocator() const {
+    return allocator_type(alloc_);
+  }
+
+  // overwrites the oldest row when full, like CircBuff::push
+  void push(const Columns& ... values) {
+    store(slot(size_), std::index_sequence_for<Columns...>(), values...);
+    if (size_ == capacity_) {
+      head_ = wrap(head_ + 1);
+    } else {
+      ++size_;
+    }
+  }
+
+  void push(const row_type& row) {
+    std::apply([this](const Columns& ... values) { push(values...); }, row);
+  }
+
+  void pop() {
+    if (empty()) throw std::runtime_error("pop from empty buffer");
+    head_ = wrap(head_ + 1);
+    --size_;
+  }
+
+  bool try_pop(row_type& out) {
+    if (empty()) return false;
+    out = row(0);
+    pop();
+    return true;
+  }
+
+  // copy of the n-th oldest row
+  row_type row(size_type n) const {
+    return load(slot(n), std::index_sequence_for<Columns...>());
+  }
+
+  // field I of the n-th oldest row
+  template<size_t I>
+  column_type<I>& get(size_type n) {
+    return std::get<I>(columns_)[slot(n)];
+  }
+
+  template<size_t I>
+  const column_type<I>& get(size_type n) const {
+    return std::get<I>(columns_)[slot(n)];
+  }
+
+  // Live values of column I from head up to the end of its array or the tail.
+  template<size_t I>
+  CircBuffSpan<column_type<I>> array_one() {
+    return CircBuffSpan<column_type<I>>(std::get<I>(columns_) + head_, first_segment_size());
+  }
+
+  template<size_t I>
+  CircBuffSpan<const column_type<I>> array_one() const {
+    return CircBuffSpan<const column_type<I>>(std::get<I>(columns_) + head_, first_segment_size());
+  }
+
+  // Live values of column I that wrapped around to the start of its array.
+  template<size_t I>
+  CircBuffSpan<column_type<I>> array_two() {
+    return CircBuffSpan<column_type<I>>(std::get<I>(columns_), size_ - first_segment_size());
+  }
+
+  template<size_t I>
+  CircBuffSpan<const column_type<I>> array_two() const {
+    return CircBuffSpan<const column_type<I>>(std::get<I>(columns_), size_ - first_segment_size());
+  }
+
+  [[nodiscard]] bool empty() const {
+    return size_ == 0;
+  }
+
+  [[nodiscard]] size_type size() const {
+    return size_;
+  }
+
+  [[nodiscard]] size_type capacity() const {
+    return capacity_;
+  }
+
+  void clear() {
+    head_ = 0;
+    size_ = 0;
+  }
+
+ private:
+  // every column starts on its own cache line
+  static constexpr size_t kAlign = std::max({kCircBuffCacheLine, alignof(Columns)...});
+
+  struct alignas(kAlign) Line {
+    unsigned char bytes[kAlign];
+  };
+  using LineAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Line>;
+  using LineTraits = std::allocator_traits<LineAllocator>;
+
+  size_type column_bytes(size_t element_size) const {
+    return (capacity_ * element_size + kAlign - 1) / kAlign * kAlign;
+  }
+
+  // every column is padded to whole lines
+  size_type lines() const {
+    return (column_bytes(sizeof(Columns)) + ...) / kAlign;
+  }
+
+  template<size_t... Is>
+  void place_columns(std::index_sequence<Is...>) {
+    size_type offset = 0;
+    ((std::get<Is>(columns_) = reinterpret_cast<column_type<Is>*>(block_ + offset),
+        offset += column_bytes(sizeof(column_type<Is>))), ...);
+  }
+
+  template<size_t... Is>
+  void store(size_type index, std::index_sequence<Is...>, const Columns& ... values) {
+    ((std::get<Is>(columns_)[index] = values), ...);
+  }
+
+  template<size_t... Is>
+  row_type load(size_type index, std::index_sequence<Is...>) const {
+    return row_type(std::get<Is>(columns_)[index]...);
+  }
+
+  size_type wrap(size_type index) const {
+    return index >= capacity_ ? index - capacity_ : index;
+  }
+
+  // array index of the n-th oldest row, n <= capacity_
+  size_type slot(size_type n) const {
+    return wrap(head_ + n);
+  }
+
+  size_type first_segment_size() const {
+    return std::min(size_, capacity_ - head_);
+  }
+
+  size_type capacity_;
+  size_type size_ = 0;
+  size_type head_ = 0;
+  LineAllocator alloc_;
+  unsigned char* block_ = nullptr;
+  std::tuple<Columns* ...> columns_;
+};
+
+template<typename... Columns>
+using CircBuffSoa = BasicCircBuffSoa<std::allocator<unsigned char>, Columns...>;
+
+#if __has_include(<memory_resource>)
+namespace pmr {
+
+template<typename... Columns>
+using CircBuffSoa = BasicCircBuffSoa<std::pmr::polymorphic_allocator<unsigned char>, Columns...>;
+
+}  // namespace pmr
+#endif
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "CircBuff.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+// Lock-free ring for exactly one producer thread and one consumer thread.
+// One slot is kept free so that head_ == tail_ always means "empty".
+// OnFull decides whether push drops an element or waits for the consumer
+// when the ring is full; overwriting would race with the consumer.
+template<typename T, typename Allocator = std::allocator<T>, CircBuffOnFull OnFull = CircBuffOnFull::reject>
+class CircBuffSpsc {
+  static_assert(OnFull != CircBuffOnFull::overwrite, "the producer cannot overwrite slots the consumer may be reading");
+
+ public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using size_type = size_t;
+  using allocator_type = Allocator;
+
+  explicit CircBuffSpsc(size_type capacity, const Allocator& alloc = Allocator())
+      : slots_(capacity + 1), alloc_(alloc) {
+    if (capacity == 0) throw std::runtime_error("spsc buffer with capacity=0");
+    data_ = alloc_.allocate(slots_);
+  }
+
+  CircBuffSpsc(const CircBuffSpsc&) = delete;
+  CircBuffSpsc& operator=(const CircBuffSpsc&) = delete;
+
+  ~CircBuffSpsc() {
+    size_type head = head_.load(std::memory_order_relaxed);
+    size_type tail = tail_.load(std::memory_order_relaxed);
+    while (head != tail) {
+      std::allocator_traits<Allocator>::destroy(alloc_, data_ + head);
+      head = next(head);
+    }
+    alloc_.deallocate(data_, slots_);
+  }
+
+  // producer side
+  bool try_push(const T& el) {
+    return try_emplace(el);
+  }
+
+  bool try_push(T&& el) {
+    return try_emplace(std::move(el));
+  }
+
+  template<typename... Args>
+  bool try_emplace(Args&& ... args) {
+    if (place(std::forward<Args>(args)...)) return true;
+    rejected_.store(rejected_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // Drops the element or waits for a free slot, depending on OnFull.
+  void push(const T& el) {
+    emplace(el);
+  }
+
+  void push(T&& el) {
+    emplace(std::move(el));
+  }
+
+  template<typename... Args>
+  void emplace(Args&& ... args) {
+    if constexpr (OnFull == CircBuffOnFull::block) {
+      while (!place(std::forward<Args>(args)...)) {
+        std::this_thread::yield();
+      }
+    } else {
+      try_emplace(std::forward<Args>(args)...);
+    }
+  }
+
+  // consumer side
+  bool try_pop(T& out) {
+    const size_type head = head_.load(std::memory_order_relaxed);
+    if (head == cached_tail_) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head == cached_tail_) return false;
+    }
+    out = std::move(data_[head]);
+    std::allocator_traits<Allocator>::destroy(alloc_, data_ + head);
+    head_.store(next(head), std::memory_order_release);
+    return true;
+  }
+
+  // size() and empty() are exact only when called from the producer or consumer
+  // while the other side is idle
+  [[nodiscard]] bool empty() const {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] size_type size() const {
+    const size_type head = head_.load(std::memory_order_acquire);
+    const size_type tail = tail_.load(std::memory_order_acquire);
+    return tail >= head ? tail - head : slots_ - head + tail;
+  }
+
+  [[nodiscard]] size_type capacity() const {
+    return slots_ - 1;
+  }
+
+  // pushes dropped because the ring was full
+  [[nodiscard]] size_type rejected() const {
+    return rejected_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // constructs at the tail unless the ring is full, args are untouched then
+  template<typename... Args>
+  bool place(Args&& ... args) {
+    const size_type tail = tail_.load(std::memory_order_relaxed);
+    const size_type next_tail = next(tail);
+    if (next_tail == cached_head_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (next_tail == cached_head_) return false;
+    }
+    std::allocator_traits<Allocator>::construct(alloc_, data_ + tail, std::forward<Args>(args)...);
+    tail_.store(next_tail, std::memory_order_release);
+    return true;
+  }
+
+  size_type next(size_type index) const {
+    return index + 1 == slots_ ? 0 : index + 1;
+  }
+
+  // read-only after construction, shared by both sides
+  size_type slots_ = 0;
+  value_type* data_ = nullptr;
+  Allocator alloc_;
+
+  // consumer cache line
+  alignas(kCircBuffCacheLine) std::atomic<size_type> head_{0};
+  size_type cached_tail_ = 0;
+
+  // producer cache line
+  alignas(kCircBuffCacheLine) std::atomic<size_type> tail_{0};
+  size_type cached_head_ = 0;
+  std::atomic<size_type> rejected_{0};
+};
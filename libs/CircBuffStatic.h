@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Ring with a compile-time capacity whose storage lives inside the object,
+// so creating one never touches the heap. Only the size_ live slots starting
+// at head_ hold constructed objects.
+template<typename T, size_t N>
+class CircBuffStatic {
+  static_assert(N > 0, "CircBuffStatic capacity must be positive");
+
+ public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using difference_type = std::ptrdiff_t;
+  using size_type = size_t;
+
+  // Iterator is a buffer pointer plus a logical offset from head, so ordering
+  // and distance stay correct when the live range wraps.
+  template<typename ReturnedValueT, typename BuffT>
+  class CircBuffIterator {
+   public:
+    using value_type = std::remove_const_t<ReturnedValueT>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = ReturnedValueT*;
+    using reference = ReturnedValueT&;
+    using iterator_category = std::random_access_iterator_tag;
+
+    constexpr CircBuffIterator() = default;
+    constexpr CircBuffIterator(BuffT* buff, size_type index) : buff_(buff), index_(index) {}
+
+    constexpr reference operator*() const { return (*buff_)[index_]; }
+    constexpr pointer operator->() const { return &(*buff_)[index_]; }
+    constexpr reference operator[](difference_type n) const { return (*buff_)[index_ + n]; }
+
+    constexpr CircBuffIterator& operator++() {
+      ++index_;
+      return *this;
+    }
+    constexpr CircBuffIterator& operator--() {
+      --index_;
+      return *this;
+    }
+    constexpr CircBuffIterator operator++(int) {
+      CircBuffIterator temp = *this;
+      ++index_;
+      return temp;
+    }
+    constexpr CircBuffIterator operator--(int) {
+      CircBuffIterator temp = *this;
+      --index_;
+      return temp;
+    }
+    constexpr CircBuffIterator& operator+=(difference_type n) {
+      index_ += n;
+      return *this;
+    }
+    constexpr CircBuffIterator& operator-=(difference_type n) {
+      index_ -= n;
+      return *this;
+    }
+    constexpr CircBuffIterator operator+(difference_type n) const { return CircBuffIterator(buff_, index_ + n); }
+    constexpr CircBuffIterator operator-(difference_type n) const { return CircBuffIterator(buff_, index_ - n); }
+    friend constexpr CircBuffIterator operator+(difference_type n, const CircBuffIterator& it) { return it + n; }
+    constexpr difference_type operator-(const CircBuffIterator& rhs) const {
+      return static_cast<difference_type>(index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    constexpr bool operator==(const CircBuffIterator& rhs) const { return index_ == rhs.index_; }
+    constexpr bool operator!=(const CircBuffIterator& rhs) const { return index_ != rhs.index_; }
+    constexpr bool operator<(const CircBuffIterator& rhs) const { return index_ < rhs.index_; }
+    constexpr bool operator>(const CircBuffIterator& rhs) const { return index_ > rhs.index_; }
+    constexpr bool operator<=(const CircBuffIterator& rhs) const { return index_ <= rhs.index_; }
+    constexpr bool operator>=(const CircBuffIterator& rhs) const { return index_ >= rhs.index_; }
+
+   private:
+    BuffT* buff_ = nullptr;
+    size_type index_ = 0;
+  };
+
+  using iterator = CircBuffIterator<T, CircBuffStatic>;
+  using const_iterator = CircBuffIterator<const T, const CircBuffStatic>;
+
+  CircBuffStatic() = default;
+
+  CircBuffStatic(std::initializer_list<T> elements) {
+    for (const auto& el : elements) {
+      push(el);
+    }
+  }
+
+  CircBuffStatic(const CircBuffStatic& other) {
+    for (const auto& el : other) {
+      push(el);
+    }
+  }
+
+  CircBuffStatic& operator=(const CircBuffStatic& other) {
+    if (this != &other) {
+      clear();
+      for (const auto& el : other) {
+        push(el);
+      }
+    }
+    return *this;
+  }
+
+  ~CircBuffStatic() {
+    clear();
+  }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, size_); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size_); }
+  const_iterator cbegin() const { return const_iterator(this, 0); }
+  const_iterator cend() const { return const_iterator(this, size_); }
+
+  [[nodiscard]] bool empty() const {
+    return size_ == 0;
+  }
+
+  [[nodiscard]] size_type size() const {
+    return size_;
+  }
+
+  [[nodiscard]] static constexpr size_type capacity() {
+    return N;
+  }
+
+  [[nodiscard]] static constexpr size_type max_size() {
+    return N;
+  }
+
+  reference operator[](size_type n) {
+    return *slot(wrap(head_ + n));
+  }
+
+  const_reference operator[](size_type n) const {
+    return *slot(wrap(head_ + n));
+  }
+
+  // overwrites the oldest element when full, like CircBuff::push
+  void push(const T& el) {
+    if (size_ == N) {
+      *slot(head_) = el;
+      head_ = wrap(head_ + 1);
+      return;
+    }
+    new(storage_ + wrap(head_ + size_) * sizeof(T)) T(el);
+    ++size_;
+  }
+
+  void pop() {
+    if (empty()) throw std::runtime_error("pop from empty buffer");
+    slot(head_)->~T();
+    head_ = wrap(head_ + 1);
+    --size_;
+  }
+
+  void clear() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (size_type i = 0; i < size_; ++i) {
+        slot(wrap(head_ + i))->~T();
+      }
+    }
+    head_ = 0;
+    size_ = 0;
+  }
+
+ private:
+  static constexpr size_type wrap(size_type index) {
+    return index % N;
+  }
+
+  T* slot(size_type index) {
+    return std::launder(reinterpret_cast<T*>(storage_ + index * sizeof(T)));
+  }
+
+  const T* slot(size_type index) const {
+    return std::launder(reinterpret_cast<const T*>(storage_ + index * sizeof(T)));
+  }
+
+  alignas(T) unsigned char storage_[sizeof(T) * N];
+  size_type head_ = 0;
+  size_type size_ = 0;
+};
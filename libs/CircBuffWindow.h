@@ -0,0 +1,156 @@
+#pragma once
+
+#include "CircBuff.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+// Sliding window over the last capacity() samples of a stream with running
+// sum, min and max. push updates them incrementally: the sum subtracts the
+// evicted sample, min and max are kept in monotonic queues whose fronts are
+// the answers. A floating-point sum carries a Neumaier compensation term and
+// is recomputed from the samples once per window and whenever an inf or NaN
+// leaves it, so cancellation and non-finite samples do not stick. Each sample enters and leaves each queue once, so a push is
+// O(1) amortized whatever the window size.
+template<typename T, typename Allocator = std::allocator<T>>
+class CircBuffWindow {
+  static_assert(std::is_arithmetic_v<T>, "CircBuffWindow needs an arithmetic sample type");
+
+  // a sample with its position in the stream, to tell when it leaves the window
+  struct Entry {
+    uint64_t seq;
+    T value;
+  };
+  using EntryAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Entry>;
+  // the queues only need room for the window, so their wrap can be a mask
+  using Queue = CircBuff<Entry, EntryAllocator, CircBuffPow2Capacity>;
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  // integers are summed in 64 bits, floating point in double
+  using sum_type = std::conditional_t<std::is_floating_point_v<T>, double,
+      std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+  using const_iterator = typename CircBuff<T, Allocator>::const_iterator;
+
+  explicit CircBuffWindow(size_type window) : samples_(window), min_(window), max_(window) {
+    if (window == 0) throw std::runtime_error("window of size 0");
+  }
+
+  void push(T value) {
+    if constexpr (std::is_floating_point_v<T>) {
+      const bool full = samples_.size() == samples_.capacity();
+      if (++since_recompute_ == samples_.capacity() || (full && !std::isfinite(samples_[0]))) {
+        samples_.push(value);
+        recompute_sum();
+      } else {
+        if (full) add(-static_cast<sum_type>(samples_[0]));
+        samples_.push(value);
+        add(value);
+      }
+    } else {
+      if (samples_.size() == samples_.capacity()) sum_ -= samples_[0];
+      samples_.push(value);
+      sum_ += value;
+    }
+    // drop the entry that just left the window, then the ones the new sample dominates
+    const uint64_t first_live = seq_ + 1 - samples_.size();
+    if (!min_.empty() && min_[0].seq < first_live) min_.pop();
+    if (!max_.empty() && max_[0].seq < first_live) max_.pop();
+    while (!min_.empty() && !(min_[min_.size() - 1].value < value)) min_.pop_back();
+    while (!max_.empty() && !(value < max_[max_.size() - 1].value)) max_.pop_back();
+    min_.push(Entry{seq_, value});
+    max_.push(Entry{seq_, value});
+    ++seq_;
+  }
+
+  [[nodiscard]] sum_type sum() const {
+    return sum_ + compensation_;
+  }
+
+  [[nodiscard]] double mean() const {
+    if (empty()) throw std::runtime_error("mean of empty window");
+    return static_cast<double>(sum()) / static_cast<double>(samples_.size());
+  }
+
+  [[nodiscard]] T min() const {
+    if (empty()) throw std::runtime_error("min of empty window");
+    return min_[0].value;
+  }
+
+  [[nodiscard]] T max() const {
+    if (empty()) throw std::runtime_error("max of empty window");
+    return max_[0].value;
+  }
+
+  // samples in the window, oldest first
+  const_iterator begin() const {
+    return samples_.cbegin();
+  }
+
+  const_iterator end() const {
+    return samples_.cend();
+  }
+
+  T operator[](size_type n) const {
+    return samples_[n];
+  }
+
+  [[nodiscard]] bool empty() const {
+    return samples_.empty();
+  }
+
+  [[nodiscard]] size_type size() const {
+    return samples_.size();
+  }
+
+  [[nodiscard]] size_type capacity() const {
+    return samples_.capacity();
+  }
+
+  void clear() {
+    samples_.clear();
+    min_.clear();
+    max_.clear();
+    sum_ = 0;
+    compensation_ = 0;
+    since_recompute_ = 0;
+  }
+
+ private:
+  // Neumaier step: keeps the low-order bits that sum_ + x rounds away
+  void add(sum_type x) {
+    const sum_type total = sum_ + x;
+    // past an inf or NaN the compensation is meaningless, the next recompute resets it
+    if (std::isfinite(total)) {
+      if (std::abs(sum_) >= std::abs(x)) {
+        compensation_ += (sum_ - total) + x;
+      } else {
+        compensation_ += (x - total) + sum_;
+      }
+    }
+    sum_ = total;
+  }
+
+  void recompute_sum() {
+    sum_ = 0;
+    compensation_ = 0;
+    since_recompute_ = 0;
+    for (T sample : samples_) {
+      add(sample);
+    }
+  }
+
+  CircBuff<T, Allocator> samples_;
+  Queue min_;
+  Queue max_;
+  sum_type sum_ = 0;
+  // always 0 for integral samples
+  sum_type compensation_ = 0;
+  size_type since_recompute_ = 0;
+  uint64_t seq_ = 0;
+};
@@ -0,0 +1,97 @@
+#include "libs/CircBuffBlocking.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(CircBuffBlockingTest, PushPopOrder) {
+  CircBuffBlocking<std::string> buff(2);
+  EXPECT_TRUE(buff.try_push("a"));
+  buff.push_wait("b");
+  EXPECT_FALSE(buff.try_push("c"));
+  EXPECT_EQ(buff.size(), 2);
+  std::string value;
+  buff.pop_wait(value);
+  EXPECT_EQ(value, "a");
+  EXPECT_TRUE(buff.try_pop(value));
+  EXPECT_EQ(value, "b");
+  EXPECT_FALSE(buff.try_pop(value));
+}
+
+TEST(CircBuffBlockingTest, TimeoutsExpire) {
+  CircBuffBlocking<int> buff(1);
+  int value = 0;
+  EXPECT_FALSE(buff.pop_wait(value, 5ms));
+  EXPECT_EQ(buff.pop_wait_batch(&value, 1, 5ms), 0);
+  EXPECT_TRUE(buff.push_wait(1, 5ms));
+  EXPECT_FALSE(buff.push_wait(2, 5ms));
+  EXPECT_TRUE(buff.pop_wait(value, 5ms));
+  EXPECT_EQ(value, 1);
+}
+
+TEST(CircBuffBlockingTest, BlockedProducerWakesAfterPop) {
+  CircBuffBlocking<int> buff(1);
+  buff.push_wait(1);
+  std::atomic<bool> pushed{false};
+  std::thread producer([&] {
+    buff.push_wait(2);
+    pushed = true;
+  });
+  std::this_thread::sleep_for(10ms);
+  EXPECT_FALSE(pushed.load());
+  int value = 0;
+  buff.pop_wait(value);
+  producer.join();
+  EXPECT_TRUE(pushed.load());
+  buff.pop_wait(value);
+  EXPECT_EQ(value, 2);
+}
+
+TEST(CircBuffBlockingTest, PopBatch) {
+  CircBuffBlocking<int> buff(8);
+  for (int i = 0; i < 5; ++i) {
+    buff.push_wait(i);
+  }
+  int values[8];
+  EXPECT_EQ(buff.pop_wait_batch(values, 3), 3);
+  EXPECT_EQ(values[2], 2);
+  EXPECT_EQ(buff.pop_wait_batch(values, 8), 2);
+  EXPECT_EQ(values[1], 4);
+  EXPECT_TRUE(buff.empty());
+}
+
+TEST(CircBuffBlockingTest, ManyProducersAndConsumers) {
+  const int64_t per_producer = 20'000;
+  const int threads = 3;
+  CircBuffBlocking<int64_t> buff(4);
+  std::atomic<int64_t> sum{0};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&buff, t, per_producer] {
+      for (int64_t i = 0; i < per_producer; ++i) {
+        buff.push_wait(t * per_producer + i);
+      }
+    });
+    workers.emplace_back([&buff, &sum, t, per_producer] {
+      int64_t values[3];
+      int64_t received = 0;
+      while (received < per_producer) {
+        // every consumer takes exactly its share, so none of them waits forever
+        const size_t n = buff.pop_wait_batch(values, std::min<int64_t>(t + 1, per_producer - received));
+        for (size_t i = 0; i < n; ++i) sum += values[i];
+        received += static_cast<int64_t>(n);
+      }
+    });
+  }
+  for (auto& worker : workers) worker.join();
+  const int64_t total = threads * per_producer;
+  EXPECT_EQ(sum.load(), total * (total - 1) / 2);
+  EXPECT_TRUE(buff.empty());
+}
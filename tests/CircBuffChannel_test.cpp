@@ -0,0 +1,104 @@
+#include "libs/CircBuffChannel.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+CircBuffTask Produce(CircBuffChannel<int>& channel, int from, int count) {
+  for (int i = from; i < from + count; ++i) {
+    co_await channel.push(i);
+  }
+}
+
+CircBuffTask Consume(CircBuffChannel<int>& channel, int count, std::vector<int>& out) {
+  for (int i = 0; i < count; ++i) {
+    out.push_back(co_await channel.pop());
+  }
+}
+
+CircBuffTask Double(CircBuffChannel<int>& in, CircBuffChannel<int>& out, int count) {
+  for (int i = 0; i < count; ++i) {
+    co_await out.push(2 * co_await in.pop());
+  }
+}
+
+}  // namespace
+
+TEST(CircBuffChannelTest, ProducerConsumerOrder) {
+  CircBuffExecutor executor;
+  CircBuffChannel<int> channel(2, executor);
+  std::vector<int> received;
+  executor.spawn(Produce(channel, 0, 10));
+  executor.spawn(Consume(channel, 10, received));
+  executor.run();
+  ASSERT_EQ(received.size(), 10);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(received[i], i);
+  }
+  EXPECT_TRUE(channel.empty());
+}
+
+TEST(CircBuffChannelTest, PoppersResumeInFifoOrder) {
+  CircBuffExecutor executor;
+  CircBuffChannel<int> channel(4, executor);
+  std::vector<int> first;
+  std::vector<int> second;
+  executor.spawn(Consume(channel, 1, first));
+  executor.spawn(Consume(channel, 1, second));
+  executor.run();
+  EXPECT_TRUE(first.empty());
+  executor.spawn(Produce(channel, 7, 2));
+  executor.run();
+  EXPECT_EQ(first, std::vector<int>{7});
+  EXPECT_EQ(second, std::vector<int>{8});
+}
+
+TEST(CircBuffChannelTest, PushersResumeInFifoOrder) {
+  CircBuffExecutor executor;
+  CircBuffChannel<int> channel(1, executor);
+  executor.spawn(Produce(channel, 0, 1));
+  executor.spawn(Produce(channel, 10, 2));
+  executor.spawn(Produce(channel, 20, 2));
+  executor.run();
+  EXPECT_EQ(channel.size(), 1);
+  std::vector<int> received;
+  executor.spawn(Consume(channel, 5, received));
+  executor.run();
+  EXPECT_EQ(received, (std::vector<int>{0, 10, 20, 11, 21}));
+}
+
+TEST(CircBuffChannelTest, PipelineStages) {
+  CircBuffExecutor executor;
+  CircBuffChannel<int> source(3, executor);
+  CircBuffChannel<int> doubled(3, executor);
+  std::vector<int> received;
+  executor.spawn(Consume(doubled, 100, received));
+  executor.spawn(Double(source, doubled, 100));
+  executor.spawn(Produce(source, 0, 100));
+  executor.run();
+  ASSERT_EQ(received.size(), 100);
+  EXPECT_EQ(received[99], 198);
+}
+
+TEST(CircBuffChannelTest, MoveOnlyValues) {
+  CircBuffExecutor executor;
+  CircBuffChannel<std::unique_ptr<std::string>> channel(1, executor);
+  std::string result;
+  auto produce = [](CircBuffChannel<std::unique_ptr<std::string>>& ch) -> CircBuffTask {
+    co_await ch.push(std::make_unique<std::string>("a"));
+    co_await ch.push(std::make_unique<std::string>("b"));
+  };
+  auto consume = [](CircBuffChannel<std::unique_ptr<std::string>>& ch, std::string& out) -> CircBuffTask {
+    for (int i = 0; i < 2; ++i) {
+      out += *co_await ch.pop();
+    }
+  };
+  executor.spawn(produce(channel));
+  executor.spawn(consume(channel, result));
+  executor.run();
+  EXPECT_EQ(result, "ab");
+}
@@ -2,6 +2,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <memory>
+#include <string>
+
 TEST(CircBuffExtendedTest, ExtendedPushTest) {
   CircBuffExtended<int> buff(3);
   buff.push(1);
@@ -12,4 +16,380 @@ TEST(CircBuffExtendedTest, ExtendedPushTest) {
   EXPECT_EQ(buff.size(), 4);
   EXPECT_EQ(*buff.begin(), 1);
   EXPECT_EQ(*(buff.begin() + 3), 4);
-}
\ No newline at end of file
+}
+
+TEST(CircBuffExtendedTest, ExtendedMoveOnlyPushTest) {
+  CircBuffExtended<std::unique_ptr<int>> buff(1);
+  buff.push(std::make_unique<int>(1));
+  buff.emplace(new int(2));
+  buff.push(std::make_unique<int>(3));
+  EXPECT_EQ(buff.capacity(), 4);
+  EXPECT_EQ(buff.size(), 3);
+  EXPECT_EQ(*buff[0], 1);
+  EXPECT_EQ(*buff[1], 2);
+  EXPECT_EQ(*buff[2], 3);
+}
+
+TEST(CircBuffExtendedTest, ExtendedGrowthMovesElementsTest) {
+  CircBuffExtended<std::string> buff;
+  for (int i = 0; i < 9; ++i) {
+    buff.push(std::string(32, static_cast<char>('a' + i)));
+  }
+  EXPECT_EQ(buff.capacity(), 16);
+  EXPECT_EQ(buff[0], std::string(32, 'a'));
+  EXPECT_EQ(buff[8], std::string(32, 'i'));
+  std::string out;
+  buff.pop_into(out);
+  EXPECT_EQ(out, std::string(32, 'a'));
+}
+
+TEST(CircBuffExtendedTest, ExtendedPushNTest) {
+  CircBuffExtended<int> buff(2);
+  buff.push(0);
+  int items[] = {1, 2, 3, 4, 5};
+  buff.push_n(items, 5);
+  EXPECT_EQ(buff.capacity(), 8);
+  EXPECT_EQ(buff.size(), 6);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(buff[i], i);
+  }
+}
+
+TEST(CircBuffExtendedTest, GrowthPolicyFactorAndStepTest) {
+  CircBuffExtended<int, std::allocator<int>, CircBuffModuloCapacity, CircBuffGrowth<std::ratio<3, 2>, 4>> buff(4);
+  for (int i = 0; i < 5; ++i) {
+    buff.push(i);
+  }
+  EXPECT_EQ(buff.capacity(), 10);
+  for (int i = 5; i < 11; ++i) {
+    buff.push(i);
+  }
+  EXPECT_EQ(buff.capacity(), 19);
+  for (int i = 0; i < 11; ++i) {
+    EXPECT_EQ(buff[i], i);
+  }
+}
+
+TEST(CircBuffExtendedTest, GrowthPolicyMaxCapacityTest) {
+  CircBuffExtended<int, std::allocator<int>, CircBuffModuloCapacity, CircBuffGrowth<std::ratio<2>, 0, 6>> buff(2);
+  for (int i = 0; i < 10; ++i) {
+    buff.push(i);
+  }
+  EXPECT_EQ(buff.capacity(), 6);
+  EXPECT_EQ(buff.size(), 6);
+  EXPECT_EQ(buff[0], 4);
+  EXPECT_EQ(buff[5], 9);
+}
+
+template<>
+struct CircBuffTriviallyRelocatable<std::unique_ptr<int>> : std::true_type {};
+
+TEST(CircBuffExtendedTest, TriviallyRelocatableGrowthTest) {
+  CircBuffExtended<std::unique_ptr<int>> buff(4);
+  for (int i = 0; i < 6; ++i) {
+    buff.push(std::make_unique<int>(i));
+  }
+  buff.pop();
+  buff.pop();
+  for (int i = 6; i < 12; ++i) {
+    buff.push(std::make_unique<int>(i));
+  }
+  EXPECT_EQ(buff.size(), 10);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(*buff[i], i + 2);
+  }
+}
+
+TEST(CircBuffExtendedTest, ShrinkToFitTest) {
+  CircBuffExtended<std::string> buff;
+  for (int i = 0; i < 20; ++i) {
+    buff.push(std::to_string(i));
+  }
+  EXPECT_EQ(buff.capacity(), 32);
+  for (int i = 0; i < 15; ++i) {
+    buff.pop();
+  }
+  buff.shrink_to_fit();
+  EXPECT_EQ(buff.capacity(), 5);
+  EXPECT_EQ(buff[0], "15");
+  EXPECT_EQ(buff[4], "19");
+  EXPECT_EQ(buff.grow_events(), 6);
+  EXPECT_EQ(buff.shrink_events(), 1);
+  buff.push("20");
+  EXPECT_EQ(buff.size(), 6);
+}
+
+TEST(CircBuffExtendedTest, SwapExchangesCountersTest) {
+  using Buff = CircBuffExtended<int, std::allocator<int>, CircBuffModuloCapacity, CircBuffGrowth<>,
+                                CircBuffHysteresisShrink<25, 4, 4>>;
+  Buff low(64);
+  for (int i = 0; i < 64; ++i) {
+    low.push(i);
+  }
+  // two low pops, two more shrink it
+  for (int i = 0; i < 50; ++i) {
+    low.pop();
+  }
+  Buff shrunk(64);
+  shrunk.push(0);
+  for (int i = 0; i < 8; ++i) {
+    shrunk.push(i);
+    shrunk.pop();
+  }
+  const auto shrinks = shrunk.shrink_events();
+  ASSERT_GT(shrinks, 0);
+  swap(low, shrunk);
+  EXPECT_EQ(low.shrink_events(), shrinks);
+  EXPECT_EQ(shrunk.shrink_events(), 0);
+  // the low pops moved with the elements
+  shrunk.pop();
+  shrunk.pop();
+  EXPECT_EQ(shrunk.capacity(), 32);
+  EXPECT_EQ(shrunk.shrink_events(), 1);
+}
+
+TEST(CircBuffExtendedTest, HysteresisShrinkTest) {
+  CircBuffExtended<int, std::allocator<int>, CircBuffModuloCapacity, CircBuffGrowth<>,
+                   CircBuffHysteresisShrink<25, 4, 4>> buff;
+  for (int i = 0; i < 64; ++i) {
+    buff.push(i);
+  }
+  EXPECT_EQ(buff.capacity(), 64);
+  for (int i = 0; i < 52; ++i) {
+    buff.pop();
+  }
+  // occupancy drops below a quarter at the 49th pop, four low pops later it halves
+  EXPECT_EQ(buff.capacity(), 32);
+  EXPECT_EQ(buff.shrink_events(), 1);
+  for (int i = 0; i < 8; ++i) {
+    buff.pop();
+  }
+  EXPECT_EQ(buff.capacity(), 16);
+  EXPECT_EQ(buff.size(), 4);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(buff[i], 60 + i);
+  }
+}
+
+TEST(CircBuffExtendedTest, StatsCountGrowthTest) {
+  CircBuffExtended<int, std::allocator<int>, CircBuffModuloCapacity, CircBuffGrowth<>,
+                   CircBuffHysteresisShrink<25, 1, 1>, CircBuffStats> buff(1);
+  for (int i = 0; i < 8; ++i) {
+    buff.push(i);
+  }
+  for (int i = 0; i < 7; ++i) {
+    buff.pop();
+  }
+  const CircBuffStatsSnapshot& stats = buff.stats().snapshot();
+  EXPECT_EQ(stats.pushes, 8);
+  EXPECT_EQ(stats.pops, 7);
+  EXPECT_EQ(stats.overwrites, 0);
+  EXPECT_EQ(stats.high_water, 8);
+  EXPECT_EQ(stats.grow_events, buff.grow_events());
+  EXPECT_EQ(stats.shrink_events, buff.shrink_events());
+  EXPECT_EQ(stats.grow_events, 3);
+  EXPECT_EQ(stats.reallocations, buff.grow_events() + buff.shrink_events());
+}
+
+TEST(CircBuffExtendedTest, ConsumeDrivesShrinkTest) {
+  CircBuffExtended<int, std::allocator<int>, CircBuffModuloCapacity, CircBuffGrowth<>,
+                   CircBuffHysteresisShrink<25, 1, 4>> buff;
+  for (int i = 0; i < 64; ++i) {
+    buff.push(i);
+  }
+  int sum = 0;
+  EXPECT_EQ(buff.consume(60, [&](int el) { sum += el; }), 60);
+  EXPECT_EQ(sum, 59 * 60 / 2);
+  EXPECT_EQ(buff.capacity(), 32);
+  EXPECT_EQ(buff.shrink_events(), 1);
+  EXPECT_EQ(buff[0], 60);
+}
+
+namespace {
+
+using IncrementalGrowth = CircBuffIncrementalGrowth<std::ratio<2>, 0, SIZE_MAX, 1>;
+
+template<typename T>
+using IncrementalBuff = CircBuffExtended<T, std::allocator<T>, CircBuffModuloCapacity, IncrementalGrowth>;
+
+// counts the moves made since the last reset
+struct MoveCounted {
+  MoveCounted() = default;
+  explicit MoveCounted(int value) : value(value) {}
+  MoveCounted(const MoveCounted& other) = default;
+  MoveCounted(MoveCounted&& other) noexcept : value(other.value) { ++moves; }
+  MoveCounted& operator=(const MoveCounted& other) = default;
+  MoveCounted& operator=(MoveCounted&& other) noexcept {
+    value = other.value;
+    ++moves;
+    return *this;
+  }
+
+  int value = 0;
+  static inline size_t moves = 0;
+};
+
+template<typename Buff>
+size_t MaxMovesPerPush(Buff& buff, int count) {
+  size_t max_moves = 0;
+  for (int i = 0; i < count; ++i) {
+    const MoveCounted el(i);
+    MoveCounted::moves = 0;
+    buff.push(el);
+    max_moves = std::max(max_moves, MoveCounted::moves);
+  }
+  return max_moves;
+}
+
+}  // namespace
+
+TEST(CircBuffExtendedTest, IncrementalGrowthSpreadsMovesTest) {
+  IncrementalBuff<std::string> buff(4);
+  for (int i = 0; i < 5; ++i) {
+    buff.push(std::to_string(i));
+  }
+  // the growing push only allocates, the four old elements are still pending
+  EXPECT_EQ(buff.capacity(), 8);
+  EXPECT_EQ(buff.size(), 5);
+  EXPECT_TRUE(buff.growing());
+  buff.push("5");
+  buff.push("6");
+  EXPECT_TRUE(buff.growing());
+  buff.push("7");
+  EXPECT_FALSE(buff.growing());
+  EXPECT_EQ(buff.grow_events(), 1);
+  ASSERT_EQ(buff.size(), 8);
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(buff[i], std::to_string(i));
+  }
+}
+
+TEST(CircBuffExtendedTest, IncrementalGrowthBoundsMovesTest) {
+  IncrementalBuff<MoveCounted> incremental(4);
+  EXPECT_LE(MaxMovesPerPush(incremental, 4096), 2);
+  CircBuffExtended<MoveCounted> eager(4);
+  EXPECT_GE(MaxMovesPerPush(eager, 4096), 2048);
+  ASSERT_EQ(incremental.size(), 4096);
+  for (int i = 0; i < 4096; ++i) {
+    EXPECT_EQ(incremental[i].value, i);
+  }
+}
+
+TEST(CircBuffExtendedTest, IncrementalGrowthPopsPendingTest) {
+  IncrementalBuff<std::string> buff(4);
+  for (int i = 0; i < 5; ++i) {
+    buff.push(std::to_string(i));
+  }
+  ASSERT_TRUE(buff.growing());
+  std::string out;
+  buff.pop_into(out);
+  EXPECT_EQ(out, "0");
+  buff.pop();
+  EXPECT_TRUE(buff.try_pop(out));
+  EXPECT_EQ(out, "2");
+  EXPECT_EQ(buff.size(), 2);
+  buff.push("5");
+  buff.pop_back();
+  EXPECT_EQ(buff.size(), 2);
+  EXPECT_FALSE(buff.growing());
+  EXPECT_EQ(buff[0], "3");
+  EXPECT_EQ(buff[1], "4");
+}
+
+TEST(CircBuffExtendedTest, IncrementalGrowthCopyMoveSwapTest) {
+  auto token = std::make_shared<int>(0);
+  {
+    IncrementalBuff<std::shared_ptr<int>> buff(8);
+    for (int i = 0; i < 10; ++i) {
+      buff.push(token);
+    }
+    ASSERT_TRUE(buff.growing());
+    IncrementalBuff<std::shared_ptr<int>> moved(std::move(buff));
+    EXPECT_TRUE(moved.growing());
+    EXPECT_EQ(moved.size(), 10);
+    IncrementalBuff<std::shared_ptr<int>> copy(moved);
+    EXPECT_FALSE(moved.growing());
+    EXPECT_EQ(copy.size(), 10);
+    EXPECT_EQ(token.use_count(), 21);
+    moved.push(token);
+    IncrementalBuff<std::shared_ptr<int>> other(2);
+    for (int i = 0; i < 5; ++i) {
+      other.push(token);
+    }
+    ASSERT_TRUE(other.growing());
+    const auto other_grows = other.grow_events();
+    const auto copy_grows = copy.grow_events();
+    ASSERT_NE(other_grows, copy_grows);
+    swap(other, copy);
+    EXPECT_EQ(other.size(), 10);
+    EXPECT_EQ(copy.size(), 5);
+    EXPECT_EQ(other.grow_events(), copy_grows);
+    EXPECT_EQ(copy.grow_events(), other_grows);
+    EXPECT_FALSE(copy.growing());
+    // destroyed with elements still pending
+    for (int i = 0; i < 4; ++i) {
+      copy.push(token);
+    }
+    EXPECT_TRUE(copy.growing());
+    EXPECT_EQ(token.use_count(), 31);
+  }
+  EXPECT_EQ(token.use_count(), 1);
+}
+
+TEST(CircBuffExtendedTest, IncrementalGrowthPow2Test) {
+  CircBuffExtended<int, std::allocator<int>, CircBuffPow2Capacity, CircBuffIncrementalGrowth<>> buff(3);
+  for (int i = 0; i < 100; ++i) {
+    buff.push(i);
+    if (i % 7 == 0) buff.pop();
+  }
+  EXPECT_EQ(buff.capacity(), 128);
+  int expected = 15;
+  for (int el : buff) {
+    EXPECT_EQ(el, expected++);
+  }
+  EXPECT_EQ(expected, 100);
+}
+
+TEST(CircBuffExtendedTest, HysteresisShrinkBelowMinCapacityTest) {
+  CircBuffExtended<int, std::allocator<int>, CircBuffModuloCapacity, CircBuffGrowth<>,
+                   CircBuffHysteresisShrink<25, 8, 16>, CircBuffStats> buff(1);
+  for (int i = 0; i < 32; ++i) {
+    buff.push(i);
+    buff.pop();
+  }
+  EXPECT_EQ(buff.capacity(), 1);
+  EXPECT_EQ(buff.grow_events(), 0);
+  EXPECT_EQ(buff.shrink_events(), 0);
+  EXPECT_EQ(buff.stats().snapshot().reallocations, 0);
+
+  CircBuffExtended<int, std::allocator<int>, CircBuffModuloCapacity, CircBuffGrowth<>,
+                   CircBuffHysteresisShrink<25, 1, 16>> wider(12);
+  for (int i = 0; i < 12; ++i) {
+    wider.push(i);
+  }
+  for (int i = 0; i < 12; ++i) {
+    wider.pop();
+  }
+  EXPECT_EQ(wider.capacity(), 12);
+  EXPECT_EQ(wider.grow_events(), 0);
+  EXPECT_EQ(wider.shrink_events(), 0);
+}
+
+TEST(CircBuffExtendedTest, MoveAssignmentTakesPendingGrowthTest) {
+  static_assert(std::is_nothrow_move_assignable_v<CircBuffExtended<int>>);
+  static_assert(std::is_nothrow_move_assignable_v<IncrementalBuff<std::string>>);
+  IncrementalBuff<std::string> source(4);
+  for (int i = 0; i < 5; ++i) {
+    source.push(std::to_string(i));
+  }
+  ASSERT_TRUE(source.growing());
+  IncrementalBuff<std::string> target(2);
+  target.push("x");
+  target = std::move(source);
+  EXPECT_TRUE(target.growing());
+  EXPECT_EQ(target.grow_events(), 1);
+  ASSERT_EQ(target.size(), 5);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(target[i], std::to_string(i));
+  }
+}
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 TEST(CircBuffIteratorTest, IncrementOperatorTest) {
   CircBuff<int> buffer(3);
   buffer.push(1);
@@ -60,4 +62,51 @@ TEST(CircBuffIteratorTest, ComparisonOperators) {
   EXPECT_TRUE(it1 != it3);
   EXPECT_FALSE(it1 == it2);
   EXPECT_TRUE(it1 != it2);
-}
\ No newline at end of file
+}
+TEST(CircBuffIteratorTest, TwoWordsTest) {
+  EXPECT_EQ(sizeof(CircBuff<int>::iterator), 2 * sizeof(void*));
+}
+
+TEST(CircBuffIteratorTest, WrappedOrderingTest) {
+  CircBuff<int> buff(4);
+  for (int i = 1; i <= 6; ++i) {
+    buff.push(i);
+  }
+  // storage is 5 6 3 4, logical order 3 4 5 6
+  auto first = buff.begin();
+  auto last = buff.end() - 1;
+  EXPECT_TRUE(first < last);
+  EXPECT_EQ(last - first, 3);
+  EXPECT_EQ(buff.end() - buff.begin(), 4);
+  EXPECT_EQ(first[2], 5);
+  EXPECT_EQ(*(last - 3), 3);
+  CircBuff<int>::const_iterator cit = first;
+  EXPECT_EQ(*cit, 3);
+}
+
+TEST(CircBuffIteratorTest, WrappedSortTest) {
+  CircBuff<int> buff(5);
+  for (int el : {0, 0, 9, 4, 7, 1, 3}) {
+    buff.push(el);
+  }
+  std::sort(buff.begin(), buff.end());
+  EXPECT_TRUE(std::is_sorted(buff.begin(), buff.end()));
+  EXPECT_EQ(buff[0], 1);
+  EXPECT_EQ(buff[4], 9);
+  auto it = std::lower_bound(buff.begin(), buff.end(), 5);
+  EXPECT_EQ(*it, 7);
+  EXPECT_EQ(it - buff.begin(), 3);
+}
+
+TEST(CircBuffIteratorTest, WrappedNthElementTest) {
+  CircBuff<int> buff(6);
+  for (int el : {50, 60, 8, 2, 6, 4, 10, 12}) {
+    buff.push(el);
+  }
+  auto middle = buff.begin() + 3;
+  std::nth_element(buff.begin(), middle, buff.end());
+  EXPECT_EQ(*middle, 8);
+  for (auto it = buff.begin(); it != middle; ++it) {
+    EXPECT_LE(*it, 8);
+  }
+}
@@ -0,0 +1,66 @@
+#include "libs/CircBuffMirrored.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+TEST(CircBuffMirroredTest, CapacityRoundedToPagesTest) {
+  CircBuffMirrored<uint8_t> buff(100);
+  if (!buff.is_mapped()) GTEST_SKIP() << "double mapping is not available";
+  EXPECT_EQ(buff.capacity() % 4096, 0);
+  EXPECT_GE(buff.capacity(), 100);
+}
+
+TEST(CircBuffMirroredTest, HalvesAliasTest) {
+  CircBuffMirrored<int32_t> buff(1024);
+  if (!buff.is_mapped()) GTEST_SKIP() << "double mapping is not available";
+  buff.push(7);
+  EXPECT_EQ(*(buff.data() + buff.capacity()), 7);
+}
+
+void CheckWrappedWindow(CircBuffMirrored<int32_t>& buff) {
+  const size_t capacity = buff.capacity();
+  std::vector<int32_t> items(capacity);
+  std::iota(items.begin(), items.end(), 0);
+  buff.push_n(items.data(), capacity);
+  buff.consume(capacity - 3);
+  int32_t tail[] = {-1, -2, -3, -4};
+  buff.push_n(tail, 4);
+  ASSERT_EQ(buff.size(), 7);
+  const int32_t* window = buff.data();
+  std::vector<int32_t> expected = {static_cast<int32_t>(capacity - 3), static_cast<int32_t>(capacity - 2),
+                                   static_cast<int32_t>(capacity - 1), -1, -2, -3, -4};
+  EXPECT_EQ(std::vector<int32_t>(window, window + 7), expected);
+  EXPECT_EQ(std::vector<int32_t>(buff.begin(), buff.end()), expected);
+  EXPECT_EQ(buff[3], -1);
+  int32_t out[7];
+  EXPECT_EQ(buff.pop_n(out, 10), 7);
+  EXPECT_EQ(std::vector<int32_t>(out, out + 7), expected);
+  EXPECT_TRUE(buff.empty());
+}
+
+TEST(CircBuffMirroredTest, WrappedWindowIsContiguousTest) {
+  CircBuffMirrored<int32_t> buff(1000);
+  CheckWrappedWindow(buff);
+}
+
+TEST(CircBuffMirroredTest, AllocatorFallbackTest) {
+  CircBuffMirrored<int32_t> buff(10, false);
+  EXPECT_FALSE(buff.is_mapped());
+  EXPECT_EQ(buff.capacity(), 10);
+  CheckWrappedWindow(buff);
+}
+
+TEST(CircBuffMirroredTest, OverwriteOldestTest) {
+  CircBuffMirrored<int32_t> buff(4, false);
+  for (int32_t i = 0; i < 6; ++i) {
+    buff.push(i);
+  }
+  EXPECT_EQ(buff.size(), 4);
+  EXPECT_EQ(buff[0], 2);
+  EXPECT_EQ(buff[3], 5);
+  buff.pop();
+  EXPECT_EQ(*buff.begin(), 3);
+}
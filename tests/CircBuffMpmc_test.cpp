@@ -0,0 +1,128 @@
+#include "libs/CircBuffMpmc.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(CircBuffMpmcTest, PushPopOrder) {
+  CircBuffMpmc<int> buff(3);
+  EXPECT_TRUE(buff.try_push(1));
+  EXPECT_TRUE(buff.try_push(2));
+  EXPECT_TRUE(buff.try_push(3));
+  EXPECT_FALSE(buff.try_push(4));
+  EXPECT_EQ(buff.size(), 3);
+  int value = 0;
+  EXPECT_TRUE(buff.try_pop(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_TRUE(buff.try_push(4));
+  for (int expected = 2; expected <= 4; ++expected) {
+    EXPECT_TRUE(buff.try_pop(value));
+    EXPECT_EQ(value, expected);
+  }
+  EXPECT_FALSE(buff.try_pop(value));
+  EXPECT_TRUE(buff.empty());
+}
+
+TEST(CircBuffMpmcTest, BatchPushPop) {
+  CircBuffMpmc<std::string> buff(5);
+  std::vector<std::string> in = {"a", "b", "c", "d", "e", "f", "g"};
+  EXPECT_EQ(buff.try_push_n(in.data(), in.size()), 5);
+  EXPECT_EQ(buff.try_push_n(in.data(), in.size()), 0);
+  std::vector<std::string> out(3);
+  EXPECT_EQ(buff.try_pop_n(out.data(), out.size()), 3);
+  EXPECT_EQ(out, std::vector<std::string>({"a", "b", "c"}));
+  EXPECT_EQ(buff.try_push_n(in.data() + 5, 2), 2);
+  out.resize(10);
+  EXPECT_EQ(buff.try_pop_n(out.data(), out.size()), 4);
+  EXPECT_EQ(out[0], "d");
+  EXPECT_EQ(out[3], "g");
+  EXPECT_EQ(buff.try_pop_n(out.data(), out.size()), 0);
+}
+
+TEST(CircBuffMpmcTest, ManyProducersManyConsumers) {
+  const int threads = 4;
+  const int64_t per_producer = 100'000;
+  CircBuffMpmc<int64_t> buff(128);
+  std::atomic<int64_t> consumed_sum{0};
+  std::atomic<int64_t> consumed_count{0};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      for (int64_t i = 0; i < per_producer; ++i) {
+        while (!buff.try_push(t * per_producer + i)) std::this_thread::yield();
+      }
+    });
+    workers.emplace_back([&] {
+      int64_t values[16];
+      while (consumed_count.load() < threads * per_producer) {
+        size_t popped = buff.try_pop_n(values, 16);
+        if (popped == 0) {
+          std::this_thread::yield();
+          continue;
+        }
+        for (size_t i = 0; i < popped; ++i) consumed_sum += values[i];
+        consumed_count += static_cast<int64_t>(popped);
+      }
+    });
+  }
+  for (auto& worker : workers) worker.join();
+  const int64_t total = threads * per_producer;
+  EXPECT_EQ(consumed_count.load(), total);
+  EXPECT_EQ(consumed_sum.load(), total * (total - 1) / 2);
+}
+
+TEST(CircBuffMpmcTest, Pow2Capacity) {
+  CircBuffMpmc<int, std::allocator<int>, CircBuffPow2Capacity> buff(3);
+  EXPECT_EQ(buff.capacity(), 4);
+  for (int i = 0; i < 10; ++i) {
+    int value = -1;
+    EXPECT_TRUE(buff.try_push(i));
+    EXPECT_TRUE(buff.try_pop(value));
+    EXPECT_EQ(value, i);
+  }
+}
+
+TEST(CircBuffMpmcTest, CapacityBelowTwoThrows) {
+  EXPECT_THROW(CircBuffMpmc<int>(0), std::runtime_error);
+  EXPECT_THROW(CircBuffMpmc<int>(1), std::runtime_error);
+  EXPECT_THROW((CircBuffMpmc<int, std::allocator<int>, CircBuffPow2Capacity>(1)), std::runtime_error);
+  CircBuffMpmc<int> buff(2);
+  EXPECT_TRUE(buff.try_push(1));
+  EXPECT_TRUE(buff.try_push(2));
+  EXPECT_FALSE(buff.try_push(3));
+}
+
+TEST(CircBuffMpmcTest, RejectPolicyCountsDrops) {
+  CircBuffMpmc<int> buff(2);
+  buff.push(1);
+  buff.push(2);
+  buff.push(3);
+  const int items[] = {4, 5};
+  EXPECT_EQ(buff.try_push_n(items, 2), 0);
+  EXPECT_EQ(buff.rejected(), 3);
+}
+
+TEST(CircBuffMpmcTest, BlockPolicyLosesNothing) {
+  const int64_t per_producer = 50'000;
+  CircBuffMpmc<int64_t, std::allocator<int64_t>, CircBuffModuloCapacity, CircBuffOnFull::block> buff(4);
+  std::vector<std::thread> producers;
+  for (int t = 0; t < 2; ++t) {
+    producers.emplace_back([&buff, t, per_producer] {
+      for (int64_t i = 0; i < per_producer; ++i) {
+        buff.push(t * per_producer + i);
+      }
+    });
+  }
+  int64_t sum = 0;
+  for (int64_t received = 0; received < 2 * per_producer; ++received) {
+    int64_t value = 0;
+    while (!buff.try_pop(value)) std::this_thread::yield();
+    sum += value;
+  }
+  for (auto& producer : producers) producer.join();
+  EXPECT_EQ(sum, 2 * per_producer * (2 * per_producer - 1) / 2);
+  EXPECT_EQ(buff.rejected(), 0);
+}
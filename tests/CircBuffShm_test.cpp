@@ -0,0 +1,77 @@
+#include "libs/CircBuffShm.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include <sys/wait.h>
+
+namespace {
+
+std::string SegmentName(const char* test) {
+  return "/CircBuffShm-" + std::to_string(getpid()) + "-" + test;
+}
+
+struct Quote {
+  int64_t seq;
+  double bid;
+  double ask;
+};
+
+}  // namespace
+
+TEST(CircBuffShmTest, PushPopSameProcess) {
+  CircBuffShm<int32_t> producer(SegmentName("same"), 3);
+  CircBuffShm<int32_t> consumer(SegmentName("same"));
+  EXPECT_EQ(consumer.capacity(), 3u);
+  EXPECT_TRUE(producer.try_push(1));
+  EXPECT_TRUE(producer.try_push(2));
+  EXPECT_TRUE(producer.try_push(3));
+  EXPECT_FALSE(producer.try_push(4));
+  EXPECT_EQ(consumer.size(), 3u);
+  int32_t value = 0;
+  EXPECT_TRUE(consumer.try_pop(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_TRUE(producer.try_push(4));
+  for (int32_t expected : {2, 3, 4}) {
+    EXPECT_TRUE(consumer.try_pop(value));
+    EXPECT_EQ(value, expected);
+  }
+  EXPECT_FALSE(consumer.try_pop(value));
+  EXPECT_TRUE(producer.empty());
+}
+
+TEST(CircBuffShmTest, AttachChecksElementType) {
+  CircBuffShm<int32_t> producer(SegmentName("type"), 8);
+  EXPECT_THROW(CircBuffShm<Quote>(SegmentName("type")), std::runtime_error);
+  EXPECT_THROW(CircBuffShm<int32_t>(SegmentName("missing")), std::runtime_error);
+}
+
+// The child maps the segment on its own, at a different address than the parent's mapping.
+TEST(CircBuffShmTest, TwoProcesses) {
+  const int64_t kItems = 200000;
+  const std::string name = SegmentName("fork");
+  CircBuffShm<Quote> producer(name, 64);
+  const pid_t child = fork();
+  ASSERT_NE(child, -1);
+  if (child == 0) {
+    CircBuffShm<Quote> consumer(name);
+    Quote quote{};
+    for (int64_t i = 0; i < kItems; ++i) {
+      while (!consumer.try_pop(quote)) std::this_thread::yield();
+      if (quote.seq != i || quote.ask != quote.bid + 1) _exit(1);
+    }
+    _exit(0);
+  }
+  for (int64_t i = 0; i < kItems; ++i) {
+    const Quote quote{i, static_cast<double>(i), static_cast<double>(i) + 1};
+    while (!producer.try_push(quote)) std::this_thread::yield();
+  }
+  int status = 0;
+  waitpid(child, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+  EXPECT_TRUE(producer.empty());
+}
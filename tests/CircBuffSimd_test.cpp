@@ -0,0 +1,96 @@
+#include "libs/CircBuffSimd.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+const CircBuffIsa kIsas[] = {CircBuffIsa::scalar, CircBuffIsa::sse42, CircBuffIsa::avx2};
+
+// Fills a buffer so that its contents wrap around the end of the block.
+template<typename T>
+CircBuff<T> MakeWrapped(size_t capacity, size_t size, uint32_t seed) {
+  CircBuff<T> buff(capacity);
+  for (size_t i = 0; i < capacity + size; ++i) {
+    seed = seed * 1103515245 + 12345;
+    buff.push(static_cast<T>(static_cast<int32_t>(seed >> 8) % 2001 - 1000));
+  }
+  while (buff.size() > size) {
+    buff.pop();
+  }
+  return buff;
+}
+
+template<typename T>
+void CheckKernels() {
+  for (size_t size : {1, 2, 3, 7, 8, 9, 31, 64, 100, 257}) {
+    const auto buff = MakeWrapped<T>(size + 13, size, static_cast<uint32_t>(size));
+    const std::vector<T> expected(buff.begin(), buff.end());
+    const auto sum = std::accumulate(expected.begin(), expected.end(), CircBuffSimd::sum_type<T>(0));
+    const T needle = expected[expected.size() * 2 / 3];
+    for (CircBuffIsa isa : kIsas) {
+      EXPECT_EQ(CircBuffSimd::sum(buff, isa), sum);
+      EXPECT_EQ(CircBuffSimd::min(buff, isa), *std::min_element(expected.begin(), expected.end()));
+      EXPECT_EQ(CircBuffSimd::max(buff, isa), *std::max_element(expected.begin(), expected.end()));
+      EXPECT_EQ(CircBuffSimd::count(buff, needle, isa),
+                static_cast<size_t>(std::count(expected.begin(), expected.end(), needle)));
+      EXPECT_EQ(CircBuffSimd::find(buff, needle, isa),
+                static_cast<size_t>(std::find(expected.begin(), expected.end(), needle) - expected.begin()));
+      EXPECT_EQ(CircBuffSimd::find(buff, T(5000), isa), buff.size());
+    }
+  }
+}
+
+}  // namespace
+
+TEST(CircBuffSimdTest, Int32KernelsMatchScalar) {
+  CheckKernels<int32_t>();
+}
+
+TEST(CircBuffSimdTest, Int64KernelsMatchScalar) {
+  CheckKernels<int64_t>();
+}
+
+TEST(CircBuffSimdTest, FloatKernelsMatchScalar) {
+  CheckKernels<float>();
+}
+
+TEST(CircBuffSimdTest, DoubleKernelsMatchScalar) {
+  CheckKernels<double>();
+}
+
+TEST(CircBuffSimdTest, EmptyBuffer) {
+  CircBuff<int32_t> buff(8);
+  EXPECT_EQ(CircBuffSimd::sum(buff), 0);
+  EXPECT_EQ(CircBuffSimd::count(buff, 1), 0u);
+  EXPECT_EQ(CircBuffSimd::find(buff, 1), 0u);
+  EXPECT_THROW((void) CircBuffSimd::min(buff), std::runtime_error);
+}
+
+TEST(CircBuffSimdTest, Int32SumDoesNotOverflow) {
+  CircBuff<int32_t> buff(100);
+  for (int i = 0; i < 100; ++i) {
+    buff.push(INT32_MAX);
+  }
+  for (CircBuffIsa isa : kIsas) {
+    EXPECT_EQ(CircBuffSimd::sum(buff, isa), int64_t(INT32_MAX) * 100);
+  }
+}
+
+TEST(CircBuffSimdTest, ExtendedMidGrowth) {
+  CircBuffExtended<int32_t, std::allocator<int32_t>, CircBuffModuloCapacity, CircBuffIncrementalGrowth<>> buff(4);
+  for (int32_t i = 1; i <= 5; ++i) {
+    buff.push(i);
+  }
+  ASSERT_TRUE(buff.growing());
+  EXPECT_EQ(CircBuffSimd::sum(buff), 15);
+  EXPECT_EQ(CircBuffSimd::min(buff), 1);
+  EXPECT_EQ(CircBuffSimd::max(buff), 5);
+  EXPECT_EQ(CircBuffSimd::count(buff, 2), 1u);
+  EXPECT_EQ(CircBuffSimd::find(buff, 2), 1u);
+  EXPECT_FALSE(buff.growing());
+}
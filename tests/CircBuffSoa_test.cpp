@@ -0,0 +1,87 @@
+#include "libs/CircBuffSoa.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+using TickRing = CircBuffSoa<int64_t, double, int32_t, uint8_t>;
+
+template<size_t I, typename Ring>
+std::vector<typename Ring::template column_type<I>> Column(const Ring& ring) {
+  std::vector<typename Ring::template column_type<I>> result;
+  for (auto value : ring.template array_one<I>()) result.push_back(value);
+  for (auto value : ring.template array_two<I>()) result.push_back(value);
+  return result;
+}
+
+}  // namespace
+
+TEST(CircBuffSoaTest, PushPopRowsTest) {
+  TickRing ring(3);
+  EXPECT_TRUE(ring.empty());
+  EXPECT_THROW(ring.pop(), std::runtime_error);
+  ring.push(1, 10.5, 100, 1);
+  ring.push(std::make_tuple(int64_t(2), 11.0, int32_t(200), uint8_t(0)));
+  EXPECT_EQ(ring.size(), 2);
+  EXPECT_EQ(ring.row(1), std::make_tuple(int64_t(2), 11.0, int32_t(200), uint8_t(0)));
+  EXPECT_EQ(ring.get<1>(0), 10.5);
+  ring.get<2>(0) = 150;
+  TickRing::row_type row;
+  EXPECT_TRUE(ring.try_pop(row));
+  EXPECT_EQ(std::get<2>(row), 150);
+  EXPECT_EQ(ring.size(), 1);
+  ring.clear();
+  EXPECT_FALSE(ring.try_pop(row));
+}
+
+TEST(CircBuffSoaTest, OverwriteOldestTest) {
+  TickRing ring(4);
+  for (int i = 0; i < 7; ++i) {
+    ring.push(i, i * 0.5, -i, static_cast<uint8_t>(i % 2));
+  }
+  EXPECT_EQ(ring.size(), 4);
+  EXPECT_EQ(Column<0>(ring), std::vector<int64_t>({3, 4, 5, 6}));
+  EXPECT_EQ(Column<1>(ring), std::vector<double>({1.5, 2.0, 2.5, 3.0}));
+  EXPECT_EQ(Column<2>(ring), std::vector<int32_t>({-3, -4, -5, -6}));
+  EXPECT_EQ(Column<3>(ring), std::vector<uint8_t>({1, 0, 1, 0}));
+}
+
+TEST(CircBuffSoaTest, SegmentsFollowWrapTest) {
+  TickRing ring(5);
+  for (int i = 0; i < 5; ++i) {
+    ring.push(i, 0, 0, 0);
+  }
+  ring.pop();
+  ring.pop();
+  ring.push(5, 0, 0, 0);
+  EXPECT_EQ(ring.array_one<0>().size(), 3);
+  EXPECT_EQ(ring.array_two<0>().size(), 1);
+  EXPECT_EQ(ring.array_two<0>()[0], 5);
+  EXPECT_EQ(Column<0>(ring), std::vector<int64_t>({2, 3, 4, 5}));
+}
+
+TEST(CircBuffSoaTest, ColumnsAreAlignedTest) {
+  CircBuffSoa<uint8_t, double> ring(3);
+  ring.push(1, 2.0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ring.array_one<0>().data()) % kCircBuffCacheLine, 0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ring.array_one<1>().data()) % kCircBuffCacheLine, 0);
+}
+
+TEST(CircBuffSoaTest, PmrArenaTest) {
+  std::pmr::monotonic_buffer_resource arena;
+  {
+    pmr::CircBuffSoa<uint8_t, double> ring(3, &arena);
+    EXPECT_EQ(ring.get_allocator().resource(), &arena);
+    ring.push(1, 2.0);
+    ring.push(3, 4.0);
+    EXPECT_EQ(ring.row(1), std::make_tuple(uint8_t{3}, 4.0));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ring.array_one<1>().data()) % kCircBuffCacheLine, 0);
+  }
+  EXPECT_THROW((pmr::CircBuffSoa<int32_t>(4, std::pmr::null_memory_resource())), std::bad_alloc);
+}
@@ -0,0 +1,103 @@
+#include "libs/CircBuffSpsc.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+TEST(CircBuffSpscTest, PushPopOrder) {
+  CircBuffSpsc<int> buff(3);
+  EXPECT_TRUE(buff.empty());
+  EXPECT_EQ(buff.capacity(), 3);
+  EXPECT_TRUE(buff.try_push(1));
+  EXPECT_TRUE(buff.try_push(2));
+  EXPECT_TRUE(buff.try_push(3));
+  EXPECT_EQ(buff.size(), 3);
+  int value = 0;
+  EXPECT_TRUE(buff.try_pop(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_TRUE(buff.try_pop(value));
+  EXPECT_EQ(value, 2);
+  EXPECT_TRUE(buff.try_pop(value));
+  EXPECT_EQ(value, 3);
+  EXPECT_FALSE(buff.try_pop(value));
+}
+
+TEST(CircBuffSpscTest, PushToFullBufferFails) {
+  CircBuffSpsc<int> buff(2);
+  EXPECT_TRUE(buff.try_push(1));
+  EXPECT_TRUE(buff.try_push(2));
+  EXPECT_FALSE(buff.try_push(3));
+  int value = 0;
+  EXPECT_TRUE(buff.try_pop(value));
+  EXPECT_TRUE(buff.try_push(3));
+  EXPECT_EQ(buff.size(), 2);
+}
+
+TEST(CircBuffSpscTest, WrapAroundWithStrings) {
+  CircBuffSpsc<std::string> buff(2);
+  std::string value;
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(buff.try_push(std::to_string(i)));
+    EXPECT_TRUE(buff.try_pop(value));
+    EXPECT_EQ(value, std::to_string(i));
+  }
+  EXPECT_TRUE(buff.try_emplace(3, 'x'));
+  EXPECT_TRUE(buff.try_pop(value));
+  EXPECT_EQ(value, "xxx");
+}
+
+TEST(CircBuffSpscTest, ZeroCapacityThrows) {
+  EXPECT_THROW(CircBuffSpsc<int>(0), std::runtime_error);
+}
+
+TEST(CircBuffSpscTest, ProducerConsumerStress) {
+  const uint64_t count = 1'000'000;
+  CircBuffSpsc<uint64_t> buff(64);
+  std::thread producer([&] {
+    for (uint64_t i = 0; i < count; ++i) {
+      while (!buff.try_push(i)) std::this_thread::yield();
+    }
+  });
+  uint64_t expected = 0;
+  uint64_t value = 0;
+  while (expected < count) {
+    if (!buff.try_pop(value)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(value, expected);
+    ++expected;
+  }
+  producer.join();
+  EXPECT_TRUE(buff.empty());
+}
+
+TEST(CircBuffSpscTest, RejectPolicyCountsDrops) {
+  CircBuffSpsc<int> buff(2);
+  buff.push(1);
+  buff.push(2);
+  buff.push(3);
+  EXPECT_FALSE(buff.try_push(4));
+  EXPECT_EQ(buff.rejected(), 2);
+  int value = 0;
+  EXPECT_TRUE(buff.try_pop(value));
+  EXPECT_EQ(value, 1);
+}
+
+TEST(CircBuffSpscTest, BlockPolicyLosesNothing) {
+  const int count = 100'000;
+  CircBuffSpsc<int, std::allocator<int>, CircBuffOnFull::block> buff(8);
+  std::thread producer([&] {
+    for (int i = 0; i < count; ++i) {
+      buff.push(i);
+    }
+  });
+  int value = 0;
+  for (int expected = 0; expected < count; ++expected) {
+    while (!buff.try_pop(value)) std::this_thread::yield();
+    ASSERT_EQ(value, expected);
+  }
+  producer.join();
+  EXPECT_EQ(buff.rejected(), 0);
+}
@@ -0,0 +1,69 @@
+#include "libs/CircBuffStatic.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+TEST(CircBuffStaticTest, PushPopTest) {
+  CircBuffStatic<int, 3> buff;
+  EXPECT_TRUE(buff.empty());
+  EXPECT_EQ(buff.capacity(), 3);
+  buff.push(1);
+  buff.push(2);
+  EXPECT_EQ(buff.size(), 2);
+  EXPECT_EQ(buff[0], 1);
+  buff.pop();
+  EXPECT_EQ(buff[0], 2);
+  buff.pop();
+  EXPECT_THROW(buff.pop(), std::runtime_error);
+}
+
+TEST(CircBuffStaticTest, CircularPushTest) {
+  CircBuffStatic<int, 3> buff{1, 2, 3, 4};
+  EXPECT_EQ(buff.size(), 3);
+  EXPECT_EQ(*buff.begin(), 2);
+  EXPECT_EQ(*(buff.end() - 1), 4);
+  int expected = 2;
+  for (int el : buff) {
+    EXPECT_EQ(el, expected++);
+  }
+}
+
+TEST(CircBuffStaticTest, SortWrappedTest) {
+  CircBuffStatic<int, 4> buff;
+  for (int el : {9, 9, 4, 1, 3, 2}) {
+    buff.push(el);
+  }
+  std::sort(buff.begin(), buff.end());
+  EXPECT_EQ(buff[0], 1);
+  EXPECT_EQ(buff[1], 2);
+  EXPECT_EQ(buff[2], 3);
+  EXPECT_EQ(buff[3], 4);
+  EXPECT_EQ(buff.end() - buff.begin(), 4);
+}
+
+TEST(CircBuffStaticTest, NonTrivialElementsTest) {
+  auto counter = std::make_shared<int>(0);
+  {
+    CircBuffStatic<std::shared_ptr<int>, 2> buff;
+    buff.push(counter);
+    buff.push(counter);
+    buff.push(counter);
+    EXPECT_EQ(counter.use_count(), 3);
+    CircBuffStatic<std::shared_ptr<int>, 2> copy(buff);
+    EXPECT_EQ(counter.use_count(), 5);
+    buff.pop();
+    EXPECT_EQ(counter.use_count(), 4);
+  }
+  EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(CircBuffStaticTest, NoHeapStorageTest) {
+  EXPECT_EQ(sizeof(CircBuffStatic<int64_t, 64>), 64 * sizeof(int64_t) + 2 * sizeof(size_t));
+  CircBuffStatic<std::string, 2> buff{"a", "b"};
+  CircBuffStatic<std::string, 2> other;
+  other = buff;
+  EXPECT_EQ(other[1], "b");
+}
@@ -0,0 +1,101 @@
+#include "libs/CircBuffWindow.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <numeric>
+
+TEST(CircBuffWindowTest, AggregatesOfSmallWindow) {
+  CircBuffWindow<int> window(3);
+  EXPECT_THROW((void) window.min(), std::runtime_error);
+  window.push(5);
+  window.push(1);
+  window.push(3);
+  EXPECT_EQ(window.sum(), 9);
+  EXPECT_EQ(window.min(), 1);
+  EXPECT_EQ(window.max(), 5);
+  EXPECT_DOUBLE_EQ(window.mean(), 3.0);
+  window.push(4);
+  EXPECT_EQ(window.sum(), 8);
+  EXPECT_EQ(window.max(), 4);
+  window.push(2);
+  window.push(2);
+  EXPECT_EQ(window.min(), 2);
+  EXPECT_EQ(window.max(), 4);
+  EXPECT_EQ(window[0], 4);
+  window.clear();
+  EXPECT_TRUE(window.empty());
+  window.push(-7);
+  EXPECT_EQ(window.min(), -7);
+  EXPECT_EQ(window.max(), -7);
+}
+
+TEST(CircBuffWindowTest, MatchesBruteForce) {
+  for (size_t size : {1, 2, 7, 100}) {
+    CircBuffWindow<int32_t> window(size);
+    std::deque<int32_t> reference;
+    uint32_t state = 3;
+    for (int i = 0; i < 5000; ++i) {
+      state = state * 1664525 + 1013904223;
+      const auto value = static_cast<int32_t>(state >> 16) % 1000 - 500;
+      window.push(value);
+      reference.push_back(value);
+      if (reference.size() > size) reference.pop_front();
+      ASSERT_EQ(window.sum(), std::accumulate(reference.begin(), reference.end(), int64_t{0}));
+      ASSERT_EQ(window.min(), *std::min_element(reference.begin(), reference.end()));
+      ASSERT_EQ(window.max(), *std::max_element(reference.begin(), reference.end()));
+    }
+  }
+}
+
+TEST(CircBuffWindowTest, WideSums) {
+  CircBuffWindow<uint8_t> bytes(1000);
+  for (int i = 0; i < 2000; ++i) {
+    bytes.push(255);
+  }
+  EXPECT_EQ(bytes.sum(), 255'000u);
+  CircBuffWindow<double> doubles(2);
+  doubles.push(0.5);
+  doubles.push(1.5);
+  doubles.push(2.5);
+  EXPECT_DOUBLE_EQ(doubles.mean(), 2.0);
+}
+
+TEST(CircBuffWindowTest, FloatingSumSurvivesCancellation) {
+  CircBuffWindow<double> window(3);
+  window.push(1e17);
+  window.push(1);
+  window.push(1);
+  window.push(1);
+  EXPECT_EQ(window.sum(), 3.0);
+  EXPECT_DOUBLE_EQ(window.mean(), 1.0);
+  // a long stream of large values cancelling each other keeps the small ones
+  CircBuffWindow<double> mixed(4);
+  for (int i = 0; i < 1000; ++i) {
+    mixed.push(i % 2 == 0 ? 1e16 : -1e16);
+    mixed.push(0.25);
+  }
+  EXPECT_EQ(mixed.sum(), 0.5);
+}
+
+TEST(CircBuffWindowTest, NonFiniteSampleLeavesTheSum) {
+  CircBuffWindow<double> window(5);
+  window.push(1.0);
+  window.push(std::nan(""));
+  EXPECT_TRUE(std::isnan(window.sum()));
+  for (int i = 0; i < 5; ++i) {
+    window.push(2.0);
+  }
+  EXPECT_EQ(window.sum(), 10.0);
+  window.push(std::numeric_limits<double>::infinity());
+  EXPECT_EQ(window.sum(), std::numeric_limits<double>::infinity());
+  for (int i = 0; i < 5; ++i) {
+    window.push(0.5);
+  }
+  EXPECT_EQ(window.sum(), 2.5);
+  EXPECT_DOUBLE_EQ(window.mean(), 0.5);
+}
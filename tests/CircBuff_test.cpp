@@ -2,6 +2,12 @@
 
 #include <gtest/gtest.h>
 
+#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
 TEST(CircBuffTest, DefaultConstructorTest) {
   CircBuff<int> cb;
   EXPECT_TRUE(cb.empty());
@@ -368,3 +374,685 @@ TEST(CircBuffTest, CountCompatibility) {
   // Проверяем, что значение 2 встречается 2 раза
   EXPECT_EQ(count, 2);
 }
+
+TEST(CircBuffTest, IndexAfterWrapTest) {
+  CircBuff<int> buff(3);
+  for (int i = 1; i <= 5; ++i) {
+    buff.push(i);
+  }
+  EXPECT_EQ(buff[0], 3);
+  EXPECT_EQ(buff[1], 4);
+  EXPECT_EQ(buff[2], 5);
+}
+
+TEST(CircBuffTest, Pow2CapacityRoundsUpTest) {
+  CircBuff<int, std::allocator<int>, CircBuffPow2Capacity> buff(5);
+  EXPECT_EQ(buff.capacity(), 8);
+  CircBuff<int, std::allocator<int>, CircBuffPow2Capacity> exact(16);
+  EXPECT_EQ(exact.capacity(), 16);
+  CircBuff<int, std::allocator<int>, CircBuffPow2Capacity> list{1, 2, 3};
+  EXPECT_EQ(list.capacity(), 4);
+  EXPECT_EQ(list.size(), 3);
+}
+
+namespace {
+
+// std::allocator that remembers the size of its last allocation
+template<typename T>
+struct SizeRecordingAllocator : std::allocator<T> {
+  SizeRecordingAllocator() = default;
+  template<typename U>
+  SizeRecordingAllocator(const SizeRecordingAllocator<U>&) {}
+  template<typename U>
+  struct rebind {
+    using other = SizeRecordingAllocator<U>;
+  };
+
+  T* allocate(size_t n) {
+    last_allocation = n;
+    return std::allocator<T>::allocate(n);
+  }
+
+  static inline size_t last_allocation = 0;
+};
+
+}  // namespace
+
+TEST(CircBuffTest, Pow2CapacityDefaultValueTest) {
+  CircBuff<std::string, SizeRecordingAllocator<std::string>, CircBuffPow2Capacity> buff(5, "x");
+  EXPECT_EQ(buff.capacity(), 8);
+  EXPECT_EQ(SizeRecordingAllocator<std::string>::last_allocation, 8);
+  EXPECT_EQ(buff.size(), 5);
+  for (int i = 0; i < 3; ++i) {
+    buff.push(std::to_string(i));
+  }
+  ASSERT_EQ(buff.size(), 8);
+  EXPECT_EQ(buff[4], "x");
+  EXPECT_EQ(buff[7], "2");
+  buff.push("3");
+  EXPECT_EQ(buff[0], "x");
+  EXPECT_EQ(buff[7], "3");
+}
+
+TEST(CircBuffTest, Pow2CapacityWrapTest) {
+  CircBuff<int, std::allocator<int>, CircBuffPow2Capacity> buff(4);
+  for (int i = 1; i <= 10; ++i) {
+    buff.push(i);
+  }
+  EXPECT_EQ(buff.size(), 4);
+  EXPECT_EQ(*buff.begin(), 7);
+  EXPECT_EQ(*(buff.begin() + 3), 10);
+  EXPECT_EQ(*(buff.end() - 1), 10);
+  int expected = 7;
+  for (int el : buff) {
+    EXPECT_EQ(el, expected++);
+  }
+  buff.pop();
+  EXPECT_EQ(buff[0], 8);
+}
+
+TEST(CircBuffTest, Pow2CapacityExtendedTest) {
+  CircBuffExtended<int, std::allocator<int>, CircBuffPow2Capacity> buff(3);
+  for (int i = 0; i < 5; ++i) {
+    buff.push(i);
+  }
+  EXPECT_EQ(buff.capacity(), 8);
+  EXPECT_EQ(buff.size(), 5);
+  EXPECT_EQ(buff[4], 4);
+}
+
+TEST(CircBuffTest, MoveConstructorTest) {
+  CircBuff<std::string> cb1{"a", "b", "c"};
+  CircBuff<std::string> cb2(std::move(cb1));
+  EXPECT_EQ(cb2.size(), 3);
+  EXPECT_EQ(cb2[2], "c");
+  EXPECT_EQ(cb1.size(), 0);
+  EXPECT_EQ(cb1.capacity(), 0);
+  EXPECT_TRUE(std::is_nothrow_move_constructible_v<CircBuff<std::string>>);
+  EXPECT_TRUE(std::is_nothrow_move_assignable_v<CircBuff<std::string>>);
+}
+
+TEST(CircBuffTest, MoveAssignmentTest) {
+  CircBuff<std::string> cb1{"a", "b"};
+  CircBuff<std::string> cb2(5);
+  cb2.push("x");
+  cb2 = std::move(cb1);
+  EXPECT_EQ(cb2.size(), 2);
+  EXPECT_EQ(cb2.capacity(), 2);
+  EXPECT_EQ(cb2[0], "a");
+  EXPECT_EQ(cb2[1], "b");
+}
+
+TEST(CircBuffTest, PushRvalueAndEmplaceTest) {
+  CircBuff<std::string> cb(2);
+  std::string value(100, 'a');
+  cb.push(std::move(value));
+  EXPECT_TRUE(value.empty());
+  cb.emplace(3, 'b');
+  cb.emplace("c");
+  EXPECT_EQ(cb.size(), 2);
+  EXPECT_EQ(cb[0], "bbb");
+  EXPECT_EQ(cb[1], "c");
+}
+
+TEST(CircBuffTest, PopIntoTest) {
+  CircBuff<std::unique_ptr<int>> cb(2);
+  cb.push(std::make_unique<int>(1));
+  cb.push(std::make_unique<int>(2));
+  std::unique_ptr<int> out;
+  cb.pop_into(out);
+  EXPECT_EQ(*out, 1);
+  EXPECT_TRUE(cb.try_pop(out));
+  EXPECT_EQ(*out, 2);
+  EXPECT_FALSE(cb.try_pop(out));
+  EXPECT_EQ(*out, 2);
+  EXPECT_THROW(cb.pop_into(out), std::runtime_error);
+}
+
+TEST(CircBuffTest, PushAfterEmptiedTest) {
+  CircBuff<int> cb(3);
+  cb.push(1);
+  cb.pop();
+  cb.push(2);
+  EXPECT_EQ(*cb.begin(), 2);
+  EXPECT_EQ(cb[0], 2);
+}
+
+TEST(CircBuffTest, PushNWrapTest) {
+  CircBuff<int> cb(5);
+  cb.push(1);
+  cb.push(2);
+  cb.push(3);
+  cb.pop();
+  cb.pop();
+  int items[] = {4, 5, 6, 7};
+  cb.push_n(items, 4);
+  EXPECT_EQ(cb.size(), 5);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(cb[i], i + 3);
+  }
+  cb.push_n(items, 2);
+  EXPECT_EQ(cb.size(), 5);
+  EXPECT_EQ(cb[0], 5);
+  EXPECT_EQ(cb[4], 5);
+  EXPECT_EQ(*(cb.end() - 1), 5);
+}
+
+TEST(CircBuffTest, PushNMoreThanCapacityTest) {
+  CircBuff<int> cb(3);
+  int items[] = {1, 2, 3, 4, 5, 6, 7};
+  cb.push_n(items, 7);
+  EXPECT_EQ(cb.size(), 3);
+  EXPECT_EQ(cb[0], 5);
+  EXPECT_EQ(cb[2], 7);
+}
+
+TEST(CircBuffTest, PopNTest) {
+  CircBuff<std::string> cb(4);
+  std::string items[] = {"a", "b", "c", "d", "e"};
+  cb.push_n(items, 5);
+  std::string out[8];
+  EXPECT_EQ(cb.pop_n(out, 3), 3);
+  EXPECT_EQ(out[0], "b");
+  EXPECT_EQ(out[2], "d");
+  EXPECT_EQ(cb.size(), 1);
+  EXPECT_EQ(cb.pop_n(out, 8), 1);
+  EXPECT_EQ(out[0], "e");
+  EXPECT_EQ(cb.pop_n(out, 8), 0);
+  EXPECT_TRUE(cb.empty());
+}
+
+TEST(CircBuffTest, SegmentViewsTest) {
+  CircBuff<int> cb(5);
+  EXPECT_TRUE(cb.array_one().empty());
+  EXPECT_TRUE(cb.array_two().empty());
+  for (int i = 1; i <= 7; ++i) {
+    cb.push(i);
+  }
+  auto one = cb.array_one();
+  auto two = cb.array_two();
+  ASSERT_EQ(one.size(), 3);
+  ASSERT_EQ(two.size(), 2);
+  EXPECT_EQ(one[0], 3);
+  EXPECT_EQ(one[2], 5);
+  EXPECT_EQ(two[0], 6);
+  EXPECT_EQ(two[1], 7);
+  EXPECT_FALSE(cb.is_linearized());
+  cb.pop();
+  cb.pop();
+  cb.pop();
+  ASSERT_EQ(cb.array_one().size(), 2);
+  EXPECT_EQ(cb.array_one()[0], 6);
+  EXPECT_TRUE(cb.array_two().empty());
+  EXPECT_TRUE(cb.is_linearized());
+}
+
+TEST(CircBuffTest, LinearizeTest) {
+  CircBuff<std::string> cb(4);
+  for (int i = 0; i < 6; ++i) {
+    cb.push(std::to_string(i));
+  }
+  auto all = cb.linearize();
+  ASSERT_EQ(all.size(), 4);
+  EXPECT_TRUE(cb.is_linearized());
+  EXPECT_TRUE(cb.array_two().empty());
+  for (size_t i = 0; i < all.size(); ++i) {
+    EXPECT_EQ(all[i], std::to_string(i + 2));
+    EXPECT_EQ(cb[i], std::to_string(i + 2));
+  }
+  cb.push("6");
+  EXPECT_EQ(cb[3], "6");
+  EXPECT_EQ(*cb.begin(), "3");
+}
+
+TEST(CircBuffTest, LinearizeNotFullStaysInBlockTest) {
+  CircBuff<std::string, std::allocator<std::string>, CircBuffModuloCapacity, CircBuffOnFull::overwrite,
+      CircBuffStats> cb(8);
+  for (int i = 0; i < 11; ++i) {
+    cb.push(std::to_string(i));
+  }
+  cb.pop();
+  cb.pop();
+  // 5..10 wrap around the end of storage, two slots are free
+  ASSERT_FALSE(cb.is_linearized());
+  const std::string* block = cb.array_two().data();
+  auto all = cb.linearize();
+  EXPECT_EQ(all.data(), block);
+  EXPECT_EQ(cb.stats().snapshot().reallocations, 0);
+  ASSERT_EQ(all.size(), 6);
+  for (size_t i = 0; i < all.size(); ++i) {
+    EXPECT_EQ(all[i], std::to_string(i + 5));
+  }
+  cb.push("11");
+  EXPECT_EQ(cb[6], "11");
+
+  CircBuff<int> ints(10);
+  for (int i = 0; i < 13; ++i) {
+    ints.push(i);
+  }
+  ints.pop();
+  ints.pop();
+  const int* ints_block = ints.array_two().data();
+  auto ints_all = ints.linearize();
+  EXPECT_EQ(ints_all.data(), ints_block);
+  ASSERT_EQ(ints_all.size(), 8);
+  for (size_t i = 0; i < ints_all.size(); ++i) {
+    EXPECT_EQ(ints_all[i], static_cast<int>(i) + 5);
+  }
+}
+
+TEST(CircBuffTest, InsertInPlaceTest) {
+  CircBuff<int> cb(8);
+  for (int i = 0; i < 10; ++i) {
+    cb.push(i);
+  }
+  cb.pop();
+  cb.pop();
+  cb.pop();
+  // 5 6 7 8 9, wrapped in storage
+  auto it = cb.insert(cb.begin() + 1, 100);
+  EXPECT_EQ(*it, 100);
+  it = cb.insert(cb.begin() + 5, 2, 200);
+  EXPECT_EQ(*it, 200);
+  EXPECT_EQ(cb.capacity(), 8);
+  EXPECT_EQ(cb.size(), 8);
+  std::vector<int> expected = {5, 100, 6, 7, 8, 200, 200, 9};
+  EXPECT_EQ(std::vector<int>(cb.begin(), cb.end()), expected);
+}
+
+TEST(CircBuffTest, InsertAtEndTest) {
+  CircBuff<int> cb(4);
+  cb.push(1);
+  cb.insert(cb.end(), {2, 3});
+  EXPECT_EQ(cb.capacity(), 4);
+  EXPECT_EQ(cb.size(), 3);
+  EXPECT_EQ(cb[2], 3);
+  cb.insert(cb.end(), {4, 5});
+  EXPECT_EQ(cb.capacity(), 5);
+  EXPECT_EQ(cb[4], 5);
+}
+
+TEST(CircBuffTest, EraseInPlaceTest) {
+  CircBuff<std::string> cb(6);
+  for (int i = 0; i < 9; ++i) {
+    cb.push(std::to_string(i));
+  }
+  // 3 4 5 6 7 8, head in the middle of storage
+  auto it = cb.erase(cb.begin() + 1);
+  EXPECT_EQ(*it, "5");
+  it = cb.erase(cb.begin() + 2, cb.begin() + 4);
+  EXPECT_EQ(*it, "8");
+  EXPECT_EQ(cb.size(), 3);
+  EXPECT_EQ(cb.capacity(), 6);
+  EXPECT_EQ(cb[0], "3");
+  EXPECT_EQ(cb[1], "5");
+  EXPECT_EQ(cb[2], "8");
+  it = cb.erase(cb.begin() + 2);
+  EXPECT_EQ(it, cb.end());
+}
+
+TEST(CircBuffTest, ReserveWrappedTest) {
+  CircBuff<int> cb(3);
+  for (int i = 1; i <= 5; ++i) {
+    cb.push(i);
+  }
+  cb.reserve(6);
+  EXPECT_EQ(cb.capacity(), 6);
+  EXPECT_EQ(cb.size(), 3);
+  EXPECT_EQ(cb[0], 3);
+  EXPECT_EQ(cb[2], 5);
+  cb.push(6);
+  EXPECT_EQ(cb[3], 6);
+}
+
+TEST(CircBuffTest, InsertEraseMatchesDequeTest) {
+  CircBuff<int> cb(16);
+  std::deque<int> reference;
+  unsigned state = 7;
+  auto next = [&state](unsigned bound) {
+    state = state * 1103515245 + 12345;
+    return (state >> 8) % bound;
+  };
+  for (int step = 0; step < 2000; ++step) {
+    const unsigned op = next(4);
+    if (op == 0 || reference.empty()) {
+      cb.push(step);
+      reference.push_back(step);
+      if (reference.size() > cb.capacity()) reference.pop_front();
+    } else if (op == 1 && reference.size() + 3 <= cb.capacity()) {
+      const unsigned pos = next(reference.size() + 1);
+      cb.insert(cb.begin() + pos, 3, step);
+      reference.insert(reference.begin() + pos, 3, step);
+    } else {
+      const unsigned pos = next(reference.size());
+      const unsigned count = 1 + next(reference.size() - pos);
+      cb.erase(cb.begin() + pos, cb.begin() + pos + count);
+      reference.erase(reference.begin() + pos, reference.begin() + pos + count);
+    }
+    ASSERT_EQ(cb.size(), reference.size());
+    for (size_t i = 0; i < reference.size(); ++i) {
+      ASSERT_EQ(cb[i], reference[i]);
+    }
+  }
+}
+
+namespace {
+
+// counts instances alive, to check that only occupied slots hold objects
+struct Tracked {
+  static int alive;
+  int value;
+
+  Tracked(int v = 0) : value(v) { ++alive; }
+  Tracked(const Tracked& other) : value(other.value) { ++alive; }
+  Tracked& operator=(const Tracked&) = default;
+  ~Tracked() { --alive; }
+};
+
+int Tracked::alive = 0;
+
+}  // namespace
+
+TEST(CircBuffTest, ConstructsOnlyLiveElementsTest) {
+  {
+    CircBuff<Tracked> cb(1000);
+    EXPECT_EQ(Tracked::alive, 0);
+    cb.push(Tracked(1));
+    cb.emplace(2);
+    EXPECT_EQ(Tracked::alive, 2);
+    cb.pop();
+    EXPECT_EQ(Tracked::alive, 1);
+    CircBuff<Tracked> copy(cb);
+    EXPECT_EQ(Tracked::alive, 2);
+    copy = cb;
+    EXPECT_EQ(Tracked::alive, 2);
+    cb.clear();
+    EXPECT_EQ(Tracked::alive, 1);
+  }
+  EXPECT_EQ(Tracked::alive, 0);
+}
+
+TEST(CircBuffTest, OverwriteKeepsLiveCountTest) {
+  {
+    CircBuff<Tracked> cb(3);
+    for (int i = 0; i < 10; ++i) {
+      cb.push(Tracked(i));
+    }
+    EXPECT_EQ(Tracked::alive, 3);
+    const Tracked items[] = {20, 21};
+    cb.pop();
+    cb.push_n(items, 2);
+    EXPECT_EQ(Tracked::alive, 5);
+    EXPECT_EQ(cb[0].value, 9);
+    EXPECT_EQ(cb[2].value, 21);
+    Tracked out[3];
+    EXPECT_EQ(cb.pop_n(out, 3), 3);
+    EXPECT_EQ(Tracked::alive, 5);
+  }
+  EXPECT_EQ(Tracked::alive, 0);
+}
+
+TEST(CircBuffTest, InsertEraseKeepsLiveCountTest) {
+  {
+    CircBuff<Tracked> cb(16);
+    unsigned state = 11;
+    auto next = [&state](unsigned bound) {
+      state = state * 1103515245 + 12345;
+      return (state >> 8) % bound;
+    };
+    for (int step = 0; step < 2000; ++step) {
+      const unsigned op = next(5);
+      if (op == 0 || cb.empty()) {
+        cb.push(Tracked(step));
+      } else if (op == 1) {
+        cb.insert(cb.begin() + next(cb.size() + 1), 1 + next(3), Tracked(step));
+      } else if (op == 2) {
+        cb.linearize();
+      } else {
+        const unsigned pos = next(cb.size());
+        cb.erase(cb.begin() + pos, cb.begin() + pos + 1 + next(cb.size() - pos));
+      }
+      ASSERT_EQ(Tracked::alive, static_cast<int>(cb.size()));
+    }
+  }
+  EXPECT_EQ(Tracked::alive, 0);
+}
+
+TEST(CircBuffTest, ClearLargeTrivialBufferTest) {
+  CircBuff<int> cb(1 << 20);
+  for (int i = 0; i < 100; ++i) {
+    cb.push(i);
+  }
+  cb.clear();
+  EXPECT_TRUE(cb.empty());
+  EXPECT_EQ(cb.capacity(), 1 << 20);
+  cb.push(7);
+  EXPECT_EQ(cb[0], 7);
+}
+
+TEST(CircBuffTest, OverwriteCountsLostElementsTest) {
+  CircBuff<int> cb(3);
+  for (int i = 0; i < 5; ++i) {
+    cb.push(i);
+  }
+  EXPECT_EQ(cb.overwritten(), 2);
+  const int items[] = {5, 6, 7, 8};
+  cb.push_n(items, 4);
+  EXPECT_EQ(cb.overwritten(), 6);
+  EXPECT_EQ(cb[0], 6);
+  EXPECT_FALSE(cb.try_push(9));
+  EXPECT_EQ(cb.rejected(), 1);
+  EXPECT_EQ(cb[2], 8);
+}
+
+TEST(CircBuffTest, RejectPolicyTest) {
+  CircBuff<std::string, std::allocator<std::string>, CircBuffModuloCapacity, CircBuffOnFull::reject> cb(2);
+  cb.push("a");
+  cb.emplace(1, 'b');
+  cb.push("c");
+  cb.emplace(1, 'd');
+  EXPECT_EQ(cb.size(), 2);
+  EXPECT_EQ(cb[0], "a");
+  EXPECT_EQ(cb[1], "b");
+  EXPECT_EQ(cb.rejected(), 2);
+  EXPECT_EQ(cb.overwritten(), 0);
+  cb.pop();
+  const std::string items[] = {"e", "f", "g"};
+  cb.push_n(items, 3);
+  EXPECT_EQ(cb[1], "e");
+  EXPECT_EQ(cb.rejected(), 4);
+}
+
+TEST(CircBuffTest, StatsPolicyTest) {
+  using StatsBuff = CircBuff<int, std::allocator<int>, CircBuffModuloCapacity, CircBuffOnFull::overwrite, CircBuffStats>;
+#if !defined(_MSC_VER)
+  // the disabled policy takes no space, MSVC ignores [[no_unique_address]]
+  static_assert(sizeof(StatsBuff) == sizeof(CircBuff<int>) + sizeof(CircBuffStats));
+#endif
+  StatsBuff buff(3);
+  for (int i = 0; i < 5; ++i) {
+    buff.push(i);
+  }
+  const int items[] = {5, 6};
+  buff.push_n(items, 2);
+  buff.pop();
+  int out[2];
+  buff.pop_n(out, 2);
+  buff.insert(buff.begin(), 3, 0);
+  const CircBuffStatsSnapshot& stats = buff.stats().snapshot();
+  EXPECT_EQ(stats.pushes, 7);
+  EXPECT_EQ(stats.overwrites, 4);
+  EXPECT_EQ(stats.pops, 3);
+  EXPECT_EQ(stats.high_water, 3);
+  EXPECT_EQ(stats.reallocations, 0);
+}
+
+TEST(CircBuffTest, StatsTimeReallocationsTest) {
+  CircBuff<int, std::allocator<int>, CircBuffModuloCapacity, CircBuffOnFull::reject, CircBuffStats> buff(2);
+  buff.push(1);
+  buff.push(2);
+  buff.push(3);
+  EXPECT_FALSE(buff.try_push(4));
+  buff.insert(buff.end(), 2, 9);
+  buff.resize(8);
+  const CircBuffStatsSnapshot& stats = buff.stats().snapshot();
+  EXPECT_EQ(stats.rejects, 2);
+  EXPECT_EQ(stats.high_water, 8);
+  EXPECT_EQ(stats.reallocations, 2);
+  uint64_t histogram_total = 0;
+  for (uint64_t bucket : stats.realloc_ns_buckets) {
+    histogram_total += bucket;
+  }
+  EXPECT_EQ(histogram_total, 2);
+}
+
+// stateful allocator whose instances compare equal only with the same id
+template<typename T, bool Propagate>
+struct TaggedAllocator {
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+  using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+  using propagate_on_container_swap = std::bool_constant<Propagate>;
+
+  explicit TaggedAllocator(int id) : id(id) {}
+  template<typename U>
+  TaggedAllocator(const TaggedAllocator<U, Propagate>& other) : id(other.id) {}
+
+  T* allocate(size_t n) { return std::allocator<T>().allocate(n); }
+  void deallocate(T* p, size_t n) { std::allocator<T>().deallocate(p, n); }
+
+  bool operator==(const TaggedAllocator& other) const { return id == other.id; }
+  bool operator!=(const TaggedAllocator& other) const { return id != other.id; }
+
+  int id;
+};
+
+TEST(CircBuffTest, AllocatorPropagationTest) {
+  using Propagating = CircBuff<std::string, TaggedAllocator<std::string, true>>;
+  Propagating a({"x", "y"}, TaggedAllocator<std::string, true>(1));
+  Propagating b(3, TaggedAllocator<std::string, true>(2));
+  b = a;
+  EXPECT_EQ(b.get_allocator().id, 1);
+  EXPECT_EQ(b[1], "y");
+  Propagating c(TaggedAllocator<std::string, true>(3));
+  c = std::move(b);
+  EXPECT_EQ(c.get_allocator().id, 1);
+
+  using Sticky = CircBuff<std::string, TaggedAllocator<std::string, false>>;
+  Sticky d({"x", "y"}, TaggedAllocator<std::string, false>(1));
+  Sticky e(2, TaggedAllocator<std::string, false>(2));
+  e = d;
+  EXPECT_EQ(e.get_allocator().id, 2);
+  EXPECT_EQ(e[0], "x");
+  Sticky f(TaggedAllocator<std::string, false>(3));
+  f = std::move(d);
+  EXPECT_EQ(f.get_allocator().id, 3);
+  EXPECT_EQ(f.size(), 2);
+  EXPECT_EQ(f[1], "y");
+  Sticky g(std::move(f), TaggedAllocator<std::string, false>(3));
+  EXPECT_EQ(g[1], "y");
+  EXPECT_TRUE(f.empty());
+}
+
+TEST(CircBuffTest, PmrArenaTest) {
+  std::pmr::monotonic_buffer_resource arena;
+  pmr::CircBuff<std::pmr::string> ring(3, &arena);
+  ring.push("a string long enough to need the heap");
+  ring.push("b");
+  EXPECT_EQ(ring.get_allocator().resource(), &arena);
+  EXPECT_EQ(ring[0].get_allocator().resource(), &arena);
+
+  // copy construction uses the default resource, assignment keeps the target's
+  pmr::CircBuff<std::pmr::string> copy(ring);
+  EXPECT_EQ(copy.get_allocator().resource(), std::pmr::get_default_resource());
+  std::pmr::monotonic_buffer_resource other_arena;
+  pmr::CircBuff<std::pmr::string> target(3, &other_arena);
+  target = ring;
+  EXPECT_EQ(target.get_allocator().resource(), &other_arena);
+  EXPECT_EQ(target[0].get_allocator().resource(), &other_arena);
+  target = std::move(copy);
+  EXPECT_EQ(target.get_allocator().resource(), &other_arena);
+  EXPECT_EQ(target[0], "a string long enough to need the heap");
+  target = {"c"};
+  EXPECT_EQ(target.get_allocator().resource(), &other_arena);
+  EXPECT_EQ(target.size(), 1);
+
+  pmr::CircBuffExtended<int> grown(1, &arena);
+  for (int i = 0; i < 100; ++i) {
+    grown.push(i);
+  }
+  EXPECT_EQ(grown.get_allocator().resource(), &arena);
+  EXPECT_EQ(grown[99], 99);
+}
+
+TEST(CircBuffTest, PmrAliasesForwardPoliciesTest) {
+  std::pmr::monotonic_buffer_resource arena;
+  pmr::CircBuff<int, CircBuffPow2Capacity, CircBuffOnFull::reject, CircBuffStats> ring(3, &arena);
+  for (int i = 0; i < 5; ++i) {
+    ring.push(i);
+  }
+  EXPECT_EQ(ring.capacity(), 4);
+  EXPECT_EQ(ring.stats().snapshot().rejects, 1);
+
+  pmr::CircBuffExtended<int, CircBuffModuloCapacity, CircBuffIncrementalGrowth<>, CircBuffHysteresisShrink<25, 1, 2>,
+      CircBuffStats> grown(2, &arena);
+  for (int i = 0; i < 16; ++i) {
+    grown.push(i);
+  }
+  for (int i = 0; i < 15; ++i) {
+    grown.pop();
+  }
+  EXPECT_EQ(grown.get_allocator().resource(), &arena);
+  EXPECT_EQ(grown[0], 15);
+  EXPECT_GT(grown.stats().snapshot().grow_events, 0);
+  EXPECT_GT(grown.stats().snapshot().shrink_events, 0);
+}
+
+TEST(CircBuffTest, ConsumeElementsTest) {
+  CircBuff<std::string> buff(4);
+  for (int i = 0; i < 6; ++i) {
+    buff.push(std::to_string(i));
+  }
+  std::vector<std::string> seen;
+  EXPECT_EQ(buff.consume(3, [&](std::string& el) { seen.push_back(std::move(el)); }), 3);
+  EXPECT_EQ(seen, std::vector<std::string>({"2", "3", "4"}));
+  EXPECT_EQ(buff.size(), 1);
+  EXPECT_EQ(buff[0], "5");
+  buff.push("6");
+  EXPECT_EQ(buff.consume_all([&](const std::string& el) { seen.push_back(el); }), 2);
+  EXPECT_EQ(seen.back(), "6");
+  EXPECT_TRUE(buff.empty());
+  EXPECT_EQ(buff.consume_all([&](std::string&) { FAIL(); }), 0);
+  CircBuff<int> no_storage;
+  EXPECT_EQ(no_storage.consume_all([](int&) {}), 0);
+}
+
+TEST(CircBuffTest, ConsumeSpansTest) {
+  CircBuff<int> buff(5);
+  for (int i = 0; i < 8; ++i) {
+    buff.push(i);
+  }
+  std::vector<size_t> runs;
+  std::vector<int> seen;
+  EXPECT_EQ(buff.consume_all([&](CircBuffSpan<int> span) {
+    runs.push_back(span.size());
+    seen.insert(seen.end(), span.begin(), span.end());
+  }), 5);
+  EXPECT_EQ(runs, std::vector<size_t>({2, 3}));
+  EXPECT_EQ(seen, std::vector<int>({3, 4, 5, 6, 7}));
+  EXPECT_TRUE(buff.empty());
+  buff.push(8);
+  EXPECT_EQ(buff[0], 8);
+}
+
+TEST(CircBuffTest, ConsumeThrowingCallbackTest) {
+  CircBuff<int> buff(5);
+  for (int i = 0; i < 5; ++i) {
+    buff.push(i);
+  }
+  EXPECT_THROW(buff.consume_all([](int& el) {
+    if (el == 2) throw std::runtime_error("stop");
+  }), std::runtime_error);
+  EXPECT_EQ(buff.size(), 3);
+  EXPECT_EQ(buff[0], 2);
+}